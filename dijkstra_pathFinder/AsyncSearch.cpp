@@ -0,0 +1,184 @@
+#include "AsyncSearch.h"
+#include <algorithm>
+
+// Most nodes the worker settles between checks for cancellation, and
+// between snapshots when the step budget is unlimited
+const size_t ASYNC_BATCH_STEPS = 4096;
+
+AsyncSearch::~AsyncSearch() {
+    cancel();
+}
+
+void AsyncSearch::start(const GridGraph &grid, int source, int target) {
+    cancel();
+
+    if (!graph || snapshotOf != &grid || snapshotRevision != grid.revision()) {
+        graph = make_shared<const CsrGraph>(grid.graph());
+        snapshotOf = &grid;
+        snapshotRevision = grid.revision();
+    }
+    src = source;
+    dest = target;
+    mode = grid.searchMode();
+
+    // A* keys add the bound GridGraph uses; Dijkstra is A* with no bound
+    heuristic = mode == SEARCH_ASTAR ? grid.heuristic(dest) : OctileHeuristic(grid.width(), dest, 0, 0);
+
+    int sides = mode == SEARCH_BIDIRECTIONAL ? 2 : 1;
+    for (int side = 0; side < 2; ++side) {
+        ws.labels[side].reset(graph->size());
+        ws.heap[side].reset(graph->size());
+    }
+    ws.labels[0].set(src, 0, -1);
+    ws.heap[0].push(src, heuristic(src));
+    if (sides == 2) {
+        ws.labels[1].set(dest, 0, -1);
+        ws.heap[1].push(dest, 0);
+    }
+
+    best = INF_DIST;
+    meetFrom[0] = meetFrom[1] = -1;
+    if (sides == 2 && src == dest) {
+        best = 0;
+        meetFrom[0] = meetFrom[1] = src;
+    }
+    expansions = 0;
+    settled.clear();
+    path.clear();
+
+    {
+        lock_guard<mutex> guard(channel);
+        pending = SearchSnapshot();
+        fresh = false;
+    }
+    budget = 0;
+    unlimited = false;
+    stopping = false;
+    worker = thread(&AsyncSearch::work, this);
+}
+
+void AsyncSearch::cancel() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    granted.notify_all();
+    if (worker.joinable()) worker.join();
+}
+
+void AsyncSearch::grant(size_t steps) {
+    {
+        lock_guard<mutex> guard(lock);
+        if (steps == 0) unlimited = true;
+        else budget += steps;
+    }
+    granted.notify_one();
+}
+
+bool AsyncSearch::poll(SearchSnapshot &snapshot) {
+    lock_guard<mutex> guard(channel);
+    if (!fresh) return false;
+
+    // Hand over the filled buffer and keep the caller's old one to refill
+    swap(snapshot, pending);
+    pending.settled.clear();
+    pending.frontier.clear();
+    pending.path.clear();
+    pending.done = false;
+    fresh = false;
+    return true;
+}
+
+void AsyncSearch::work() {
+    while (true) {
+        size_t steps;
+        {
+            unique_lock<mutex> guard(lock);
+            granted.wait(guard, [this] { return stopping || unlimited || budget > 0; });
+            if (stopping) return;
+            steps = unlimited ? ASYNC_BATCH_STEPS : min(budget, ASYNC_BATCH_STEPS);
+            if (!unlimited) budget -= steps;
+        }
+
+        bool more = true;
+        for (size_t i = 0; i < steps && more; ++i) more = step();
+        if (!more) finish();
+        publish(!more);
+        if (!more) return;
+    }
+}
+
+// Function to settle one node; returns false once the search is over
+bool AsyncSearch::step() {
+    SearchLabels *labels = ws.labels;
+    IndexedHeap *heap = ws.heap;
+
+    if (mode != SEARCH_BIDIRECTIONAL) {
+        if (heap[0].empty()) return false;
+        int u = heap[0].pop();
+        settled.push_back(u);
+        expansions++;
+        if (u == dest) return false;
+
+        int d = labels[0].dist(u);
+        graph->forEachEdge(u, [&](int v, int weight) {
+            if (d + weight < labels[0].dist(v)) {
+                labels[0].set(v, d + weight, u);
+                heap[0].push(v, d + weight + heuristic(v));
+            }
+        });
+        return true;
+    }
+
+    // Same meeting rule as bidirectionalPath, one node at a time
+    if (heap[0].empty() || heap[1].empty()) return false;
+    if (static_cast<long long>(heap[0].topKey()) + heap[1].topKey() >= best) return false;
+
+    int side = heap[0].topKey() <= heap[1].topKey() ? 0 : 1;
+    int d = heap[side].topKey();
+    int u = heap[side].pop();
+    settled.push_back(u);
+    expansions++;
+
+    SearchLabels &mine = labels[side];
+    const SearchLabels &other = labels[1 - side];
+    graph->forEachEdge(u, [&](int v, int weight) {
+        if (d + weight < mine.dist(v)) {
+            mine.set(v, d + weight, u);
+            heap[side].push(v, d + weight);
+        }
+        if (other.reached(v) && static_cast<long long>(d) + weight + other.dist(v) < best) {
+            best = static_cast<long long>(d) + weight + other.dist(v);
+            meetFrom[side] = u;
+            meetFrom[1 - side] = v;
+        }
+    });
+    return true;
+}
+
+void AsyncSearch::finish() {
+    if (mode != SEARCH_BIDIRECTIONAL || meetFrom[0] < 0) {
+        tracePath(ws.labels[0], dest, path);
+        return;
+    }
+
+    tracePath(ws.labels[0], meetFrom[0], path);
+    if (meetFrom[1] != meetFrom[0]) {
+        for (int at = meetFrom[1]; at != -1; at = ws.labels[1].prev(at)) path.push_back(at);
+    }
+}
+
+void AsyncSearch::publish(bool done) {
+    vector<int> frontier;
+    ws.heap[0].forEachNode([&](int u) { frontier.push_back(u); });
+    if (mode == SEARCH_BIDIRECTIONAL) ws.heap[1].forEachNode([&](int u) { frontier.push_back(u); });
+
+    lock_guard<mutex> guard(channel);
+    pending.settled.insert(pending.settled.end(), settled.begin(), settled.end());
+    settled.clear();
+    pending.frontier.swap(frontier);
+    pending.expansions = expansions;
+    pending.done = done;
+    if (done) pending.path = path;
+    fresh = true;
+}
@@ -0,0 +1,85 @@
+#ifndef ASYNCSEARCH_H
+#define ASYNCSEARCH_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <cstddef>
+#include "GridGraph.h"
+#include "CsrGraph.h"
+
+using namespace std;
+
+// Progress of a search as the render loop sees it
+struct SearchSnapshot {
+    vector<int> settled;   // nodes settled since the previous snapshot
+    vector<int> frontier;  // nodes queued right now
+    vector<int> path;      // the result, once done, in the format Graph::dijkstra returns
+    size_t expansions = 0; // nodes settled so far
+    bool done = false;
+};
+
+// Runs a GridGraph route search on a worker thread, so a large search never
+// blocks event handling or drawing. The worker searches an immutable CSR
+// snapshot of the graph, and a new start() or cancel() abandons the old
+// search. start() takes a new snapshot only when the grid was edited since
+// the last one, so moving the endpoints or switching modes copies nothing.
+//
+// The render loop hands out expansions with grant() and collects progress
+// with poll(). Snapshots are double-buffered: the worker fills one buffer
+// and poll() swaps it with the caller's, holding the lock only for the swap.
+// Settled nodes accumulate until polled, so no frame's progress is lost.
+class AsyncSearch {
+public:
+    AsyncSearch() = default;
+    ~AsyncSearch();
+    AsyncSearch(const AsyncSearch&) = delete;
+    AsyncSearch& operator=(const AsyncSearch&) = delete;
+
+    void start(const GridGraph &grid, int src, int dest);
+    void cancel();
+
+    // Lets the worker settle `steps` more nodes; 0 lifts the limit
+    void grant(size_t steps);
+
+    // Function to take the progress made since the last call; returns false
+    // if there is none
+    bool poll(SearchSnapshot &snapshot);
+
+private:
+    void work();
+    bool step();
+    void finish();
+    void publish(bool done);
+
+    // Snapshot of the grid's graph and the grid revision it was taken at
+    shared_ptr<const CsrGraph> graph;
+    const GridGraph *snapshotOf = nullptr;
+    unsigned long snapshotRevision = 0;
+
+    // Search state, owned by the worker while it runs
+    int src = -1, dest = -1;
+    SearchMode mode = SEARCH_ASTAR;
+    OctileHeuristic heuristic = OctileHeuristic(1, 0, 0, 0);
+    SearchWorkspace ws;
+    long long best = INF_DIST;
+    int meetFrom[2] = { -1, -1 };
+    size_t expansions = 0;
+    vector<int> settled;
+    vector<int> path;
+
+    thread worker;
+    mutex lock;
+    condition_variable granted;
+    size_t budget = 0;
+    bool unlimited = false;
+    bool stopping = false;
+
+    mutex channel;
+    SearchSnapshot pending;
+    bool fresh = false;
+};
+
+#endif
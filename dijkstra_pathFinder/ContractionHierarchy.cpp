@@ -0,0 +1,388 @@
+#include "ContractionHierarchy.h"
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <queue>
+
+const char CH_MAGIC[4] = { 'C', 'H', '0', '1' };
+
+// A witness search gives up after settling this many nodes and adds the
+// shortcut; that only costs a redundant edge, never a wrong distance
+const int WITNESS_SETTLE_LIMIT = 500;
+
+struct ChEdge {
+    int to;
+    int weight;
+    int middle;
+};
+
+struct Shortcut {
+    int from, to, weight;
+};
+
+// Working state of the contraction: the graph of nodes not yet contracted,
+// with shortcuts added, plus the witness search buffers
+struct Contractor {
+    int n;
+    vector<vector<ChEdge>> adj;
+    vector<vector<ChEdge>> up;
+    vector<int> deleted; // contracted neighbours per node
+    SearchLabels labels;
+    IndexedHeap heap;
+
+    // Function to add edge a - b, or lower its weight if it already exists
+    void addEdge(int a, int b, int weight, int middle) {
+        for (int side = 0; side < 2; ++side) {
+            vector<ChEdge> &list = adj[side == 0 ? a : b];
+            int to = side == 0 ? b : a;
+            bool found = false;
+            for (ChEdge &edge : list) {
+                if (edge.to == to) {
+                    if (weight < edge.weight) edge = { to, weight, middle };
+                    found = true;
+                    break;
+                }
+            }
+            if (!found) list.push_back({ to, weight, middle });
+        }
+    }
+
+    // Function to run Dijkstra from u without passing through `via`,
+    // settling nodes no further than maxDist
+    void witnessSearch(int u, int via, int maxDist) {
+        labels.reset(n);
+        heap.reset(n);
+        labels.set(u, 0, -1);
+        heap.push(u, 0);
+
+        for (int settled = 0; !heap.empty() && settled < WITNESS_SETTLE_LIMIT; ++settled) {
+            int d = heap.topKey();
+            if (d > maxDist) break;
+            int x = heap.pop();
+            for (const ChEdge &edge : adj[x]) {
+                if (edge.to == via) continue;
+                if (d + edge.weight < labels.dist(edge.to)) {
+                    labels.set(edge.to, d + edge.weight, x);
+                    heap.push(edge.to, d + edge.weight);
+                }
+            }
+        }
+    }
+
+    // Function to find the shortcuts that contracting v needs: one for each
+    // pair of neighbours whose shortest connection runs through v
+    void findShortcuts(int v, vector<Shortcut> &shortcuts) {
+        shortcuts.clear();
+        const vector<ChEdge> &neighbors = adj[v];
+        for (size_t i = 0; i < neighbors.size(); ++i) {
+            int maxDist = 0;
+            for (size_t j = i + 1; j < neighbors.size(); ++j) maxDist = max(maxDist, neighbors[j].weight);
+            if (i + 1 == neighbors.size()) break;
+            maxDist += neighbors[i].weight;
+
+            witnessSearch(neighbors[i].to, v, maxDist);
+            for (size_t j = i + 1; j < neighbors.size(); ++j) {
+                int through = neighbors[i].weight + neighbors[j].weight;
+                if (labels.dist(neighbors[j].to) > through) {
+                    shortcuts.push_back({ neighbors[i].to, neighbors[j].to, through });
+                }
+            }
+        }
+    }
+
+    // Importance of v: shortcuts added minus edges removed, plus how many
+    // neighbours are gone already, which spreads contraction evenly
+    int priority(int v, vector<Shortcut> &shortcuts) {
+        findShortcuts(v, shortcuts);
+        return static_cast<int>(shortcuts.size()) - static_cast<int>(adj[v].size()) + deleted[v];
+    }
+
+    void contract(int v, const vector<Shortcut> &shortcuts) {
+        up[v] = adj[v];
+        for (const ChEdge &edge : adj[v]) {
+            vector<ChEdge> &list = adj[edge.to];
+            for (size_t i = 0; i < list.size(); ++i) {
+                if (list[i].to == v) {
+                    list[i] = list.back();
+                    list.pop_back();
+                    break;
+                }
+            }
+            deleted[edge.to]++;
+        }
+        adj[v].clear();
+        adj[v].shrink_to_fit();
+
+        for (const Shortcut &shortcut : shortcuts) addEdge(shortcut.from, shortcut.to, shortcut.weight, v);
+    }
+};
+
+void ContractionHierarchy::build(const CsrGraph &graph, ChBuildStats *stats) {
+    auto start = chrono::steady_clock::now();
+    n = graph.size();
+
+    Contractor contractor;
+    contractor.n = n;
+    contractor.adj.assign(n, {});
+    contractor.up.assign(n, {});
+    contractor.deleted.assign(n, 0);
+    for (int u = 0; u < n; ++u) {
+        graph.forEachEdge(u, [&](int v, int weight) {
+            if (u < v) contractor.addEdge(u, v, weight, -1);
+        });
+    }
+
+    // Contract the least important node first. Priorities change as the
+    // graph shrinks, so each pick is re-evaluated lazily: a node whose
+    // fresh priority is worse than the next candidate goes back in the queue.
+    vector<Shortcut> shortcuts;
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> order;
+    for (int v = 0; v < n; ++v) order.emplace(contractor.priority(v, shortcuts), v);
+
+    rank.assign(n, -1);
+    size_t shortcutCount = 0;
+    int nextRank = 0;
+    while (!order.empty()) {
+        int v = order.top().second;
+        order.pop();
+        if (rank[v] >= 0) continue;
+
+        int current = contractor.priority(v, shortcuts);
+        if (!order.empty() && current > order.top().first) {
+            order.emplace(current, v);
+            continue;
+        }
+
+        contractor.contract(v, shortcuts);
+        shortcutCount += shortcuts.size();
+        rank[v] = nextRank++;
+    }
+
+    offsets.assign(n + 1, 0);
+    for (int u = 0; u < n; ++u) offsets[u + 1] = offsets[u] + contractor.up[u].size();
+    targets.resize(offsets[n]);
+    weights.resize(offsets[n]);
+    middles.resize(offsets[n]);
+    for (int u = 0; u < n; ++u) {
+        uint64_t e = offsets[u];
+        for (const ChEdge &edge : contractor.up[u]) {
+            targets[e] = edge.to;
+            weights[e] = edge.weight;
+            middles[e] = edge.middle;
+            e++;
+        }
+    }
+
+    if (stats != nullptr) {
+        stats->seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        stats->shortcuts = shortcutCount;
+        stats->indexBytes = indexBytes();
+    }
+}
+
+size_t ContractionHierarchy::indexBytes() const {
+    return rank.size() * sizeof(int) + offsets.size() * sizeof(uint64_t)
+        + targets.size() * (sizeof(int32_t) * 3);
+}
+
+// Function to find the upward edge between a and b, stored at the lower
+// ranked of the two
+int ContractionHierarchy::findEdge(int a, int b) const {
+    if (rank[a] > rank[b]) swap(a, b);
+    for (uint64_t e = offsets[a]; e < offsets[a + 1]; ++e) {
+        if (targets[e] == b) return static_cast<int>(e);
+    }
+    return -1;
+}
+
+// Function to append the original nodes after `from` on the edge from -> to,
+// expanding shortcuts into the two edges they replace; false if an edge it
+// needs is missing
+bool ContractionHierarchy::unpack(int from, int to, vector<int> &path) const {
+    vector<pair<int, int>> pending = { { from, to } };
+    while (!pending.empty()) {
+        int a = pending.back().first;
+        int b = pending.back().second;
+        pending.pop_back();
+
+        int e = findEdge(a, b);
+        if (e < 0) {
+            cerr << "Invalid hierarchy: no edge between " << a << " and " << b << endl;
+            return false;
+        }
+        int middle = middles[e];
+        if (middle < 0) {
+            path.push_back(b);
+        } else {
+            pending.push_back({ middle, b });
+            pending.push_back({ a, middle });
+        }
+    }
+    return true;
+}
+
+const vector<int>& ContractionHierarchy::query(int src, int dest, SearchWorkspace &ws, int *distance) const {
+    SearchLabels *labels = ws.labels;
+    IndexedHeap *heap = ws.heap;
+    for (int side = 0; side < 2; ++side) {
+        labels[side].reset(n);
+        heap[side].reset(n);
+    }
+    labels[0].set(src, 0, -1);
+    labels[1].set(dest, 0, -1);
+    heap[0].push(src, 0);
+    heap[1].push(dest, 0);
+
+    // Both searches only climb; they meet at the top node of the path
+    long long best = INF_DIST;
+    int meet = -1;
+    while (!heap[0].empty() || !heap[1].empty()) {
+        int side;
+        if (heap[0].empty()) side = 1;
+        else if (heap[1].empty()) side = 0;
+        else side = heap[0].topKey() <= heap[1].topKey() ? 0 : 1;
+
+        int d = heap[side].topKey();
+        if (d >= best) {
+            // Nothing left on this side can improve the meeting
+            heap[side].reset(n);
+            continue;
+        }
+
+        int u = heap[side].pop();
+        const SearchLabels &other = labels[1 - side];
+        if (other.reached(u) && static_cast<long long>(d) + other.dist(u) < best) {
+            best = static_cast<long long>(d) + other.dist(u);
+            meet = u;
+        }
+
+        for (uint64_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+            int v = targets[e];
+            if (d + weights[e] < labels[side].dist(v)) {
+                labels[side].set(v, d + weights[e], u);
+                heap[side].push(v, d + weights[e]);
+            }
+        }
+    }
+
+    vector<int> &path = ws.path;
+    path.clear();
+    if (distance != nullptr) *distance = meet < 0 ? INF_DIST : static_cast<int>(best);
+    if (meet < 0) {
+        path.push_back(dest);
+        return path;
+    }
+
+    // Climb from src to the meeting node, then descend to dest
+    vector<int> up;
+    for (int at = meet; at != -1; at = labels[0].prev(at)) up.push_back(at);
+    reverse(up.begin(), up.end());
+
+    path.push_back(src);
+    bool ok = true;
+    for (size_t i = 1; ok && i < up.size(); ++i) ok = unpack(up[i - 1], up[i], path);
+    for (int at = meet; ok && labels[1].prev(at) != -1; at = labels[1].prev(at)) ok = unpack(at, labels[1].prev(at), path);
+    if (!ok) {
+        // Report the route as unreachable rather than a broken path
+        if (distance != nullptr) *distance = INF_DIST;
+        path.assign(1, dest);
+    }
+    return path;
+}
+
+vector<int> ContractionHierarchy::query(int src, int dest, int *distance) const {
+    SearchWorkspace ws;
+    return query(src, dest, ws, distance);
+}
+
+bool ContractionHierarchy::save(const string &fileName) const {
+    FILE *file = fopen(fileName.c_str(), "wb");
+    if (!file) {
+        cerr << "Error opening file: " << fileName << endl;
+        return false;
+    }
+
+    uint32_t reserved = 0;
+    uint64_t nodes = n, edges = targets.size();
+    bool ok = fwrite(CH_MAGIC, 1, sizeof(CH_MAGIC), file) == sizeof(CH_MAGIC)
+        && fwrite(&reserved, sizeof(reserved), 1, file) == 1
+        && fwrite(&nodes, sizeof(nodes), 1, file) == 1
+        && fwrite(&edges, sizeof(edges), 1, file) == 1
+        && fwrite(rank.data(), sizeof(int32_t), nodes, file) == nodes
+        && fwrite(offsets.data(), sizeof(uint64_t), nodes + 1, file) == nodes + 1
+        && fwrite(targets.data(), sizeof(int32_t), edges, file) == edges
+        && fwrite(weights.data(), sizeof(int32_t), edges, file) == edges
+        && fwrite(middles.data(), sizeof(int32_t), edges, file) == edges;
+    ok = fclose(file) == 0 && ok;
+
+    if (!ok) cerr << "Error writing file: " << fileName << endl;
+    return ok;
+}
+
+bool ContractionHierarchy::load(const string &fileName) {
+    FILE *file = fopen(fileName.c_str(), "rb");
+    if (!file) {
+        cerr << "Error opening file: " << fileName << endl;
+        return false;
+    }
+
+    char magic[4];
+    uint32_t reserved;
+    uint64_t nodes = 0, edges = 0;
+    bool ok = fread(magic, 1, sizeof(magic), file) == sizeof(magic)
+        && fread(&reserved, sizeof(reserved), 1, file) == 1
+        && fread(&nodes, sizeof(nodes), 1, file) == 1
+        && fread(&edges, sizeof(edges), 1, file) == 1
+        && memcmp(magic, CH_MAGIC, sizeof(magic)) == 0
+        && nodes < static_cast<uint64_t>(numeric_limits<int>::max())
+        && edges < static_cast<uint64_t>(numeric_limits<int>::max());
+    if (ok) {
+        rank.resize(nodes);
+        offsets.resize(nodes + 1);
+        targets.resize(edges);
+        weights.resize(edges);
+        middles.resize(edges);
+        ok = fread(rank.data(), sizeof(int32_t), nodes, file) == nodes
+            && fread(offsets.data(), sizeof(uint64_t), nodes + 1, file) == nodes + 1
+            && fread(targets.data(), sizeof(int32_t), edges, file) == edges
+            && fread(weights.data(), sizeof(int32_t), edges, file) == edges
+            && fread(middles.data(), sizeof(int32_t), edges, file) == edges;
+    }
+    fclose(file);
+
+    // Check everything a query and unpacking follow, so a bad file cannot
+    // send them out of bounds or round in circles: ranks are a permutation,
+    // every edge leads upwards, and every shortcut bypasses a node ranked
+    // below both ends whose two halves exist. Unpacking then always moves
+    // to lower-ranked pairs, so it ends.
+    ok = ok && offsets[0] == 0 && offsets[nodes] == edges;
+    vector<bool> ranked(ok ? nodes : 0, false);
+    for (uint64_t u = 0; ok && u < nodes; ++u) {
+        ok = offsets[u] <= offsets[u + 1] && rank[u] >= 0 && static_cast<uint64_t>(rank[u]) < nodes && !ranked[rank[u]];
+        if (ok) ranked[rank[u]] = true;
+    }
+    for (uint64_t u = 0; ok && u < nodes; ++u) {
+        for (uint64_t e = offsets[u]; ok && e < offsets[u + 1]; ++e) {
+            int v = targets[e], middle = middles[e];
+            ok = v >= 0 && static_cast<uint64_t>(v) < nodes && rank[v] > rank[u] && weights[e] >= 0
+                && middle >= -1 && static_cast<int64_t>(middle) < static_cast<int64_t>(nodes);
+            if (ok && middle >= 0) {
+                ok = rank[middle] < rank[u] && findEdge(middle, static_cast<int>(u)) >= 0 && findEdge(middle, v) >= 0;
+            }
+        }
+    }
+
+    if (!ok) {
+        cerr << "Invalid hierarchy file: " << fileName << endl;
+        n = 0;
+        rank.clear();
+        offsets.clear();
+        targets.clear();
+        weights.clear();
+        middles.clear();
+        return false;
+    }
+    n = static_cast<int>(nodes);
+    return true;
+}
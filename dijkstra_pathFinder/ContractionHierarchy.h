@@ -0,0 +1,61 @@
+#ifndef CONTRACTIONHIERARCHY_H
+#define CONTRACTIONHIERARCHY_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "CsrGraph.h"
+
+using namespace std;
+
+struct ChBuildStats {
+    double seconds = 0;
+    size_t shortcuts = 0;
+    size_t indexBytes = 0;
+};
+
+// Contraction hierarchy over an undirected graph, for fast repeat queries
+// on a graph that rarely changes. Preprocessing contracts nodes one at a
+// time, cheapest first, adding a shortcut between two neighbours whenever
+// the path through the contracted node is the only shortest one. Every edge
+// then points from a node to a more important one, and a query is a
+// bidirectional Dijkstra that only ever goes upwards and touches a tiny
+// part of the graph. Shortcuts remember the node they bypass, so paths
+// unpack into original edges.
+//
+// File layout (native byte order):
+//   "CH01" | u32 0 | u64 nodes | u64 edges | i32 rank[nodes] |
+//   u64 offsets[nodes + 1] | i32 targets[edges] | i32 weights[edges] | i32 middles[edges]
+class ContractionHierarchy {
+public:
+    void build(const CsrGraph &graph, ChBuildStats *stats = nullptr);
+
+    bool save(const string &fileName) const;
+    bool load(const string &fileName);
+
+    int size() const { return n; }
+    size_t edgeCount() const { return targets.size(); }
+    size_t indexBytes() const;
+
+    // Shortest path in the format Graph::dijkstra returns; distance, if
+    // given, receives its length (INF_DIST if dest cannot be reached)
+    vector<int> query(int src, int dest, int *distance = nullptr) const;
+    const vector<int>& query(int src, int dest, SearchWorkspace &workspace, int *distance = nullptr) const;
+
+private:
+    int findEdge(int a, int b) const;
+    bool unpack(int from, int to, vector<int> &path) const;
+
+    int n = 0;
+    vector<int> rank;
+
+    // Upward graph: the edges of u lead to higher-ranked nodes; `middles`
+    // is the bypassed node of a shortcut, -1 for an original edge
+    vector<uint64_t> offsets;
+    vector<int32_t> targets;
+    vector<int32_t> weights;
+    vector<int32_t> middles;
+};
+
+#endif
@@ -0,0 +1,203 @@
+#include "CsrGraph.h"
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <sys/stat.h>
+#endif
+
+const char CSR_MAGIC[4] = { 'C', 'S', 'R', '1' };
+const size_t CSR_HEADER_SIZE = 32;
+
+// Function to find the size of an open file
+static bool fileSize(FILE *file, uint64_t &size) {
+#ifndef _WIN32
+    struct stat info;
+    if (fstat(fileno(file), &info) != 0) return false;
+#else
+    struct _stat64 info;
+    if (_fstat64(_fileno(file), &info) != 0) return false;
+#endif
+    size = info.st_size;
+    return true;
+}
+
+CsrGraph::CsrGraph(const Graph &graph) : n(graph.size()) {
+    ownedOffsets.resize(n + 1);
+    ownedOffsets[0] = 0;
+    for (int u = 0; u < n; ++u) {
+        ownedOffsets[u + 1] = ownedOffsets[u] + graph.neighbors(u).size();
+    }
+
+    m = ownedOffsets[n];
+    ownedTargets.resize(m);
+    ownedWeights.resize(m);
+    for (int u = 0; u < n; ++u) {
+        uint64_t e = ownedOffsets[u];
+        for (const auto &neighbor : graph.neighbors(u)) {
+            ownedTargets[e] = neighbor.first;
+            ownedWeights[e] = neighbor.second;
+            minW = min(minW, neighbor.second);
+            maxW = max(maxW, neighbor.second);
+            e++;
+        }
+    }
+
+    offsets = ownedOffsets.data();
+    targets = ownedTargets.data();
+    weights = ownedWeights.data();
+}
+
+CsrGraph::~CsrGraph() {
+    release();
+}
+
+void CsrGraph::release() {
+#ifndef _WIN32
+    if (mapping != nullptr) munmap(mapping, mappingSize);
+#endif
+    mapping = nullptr;
+    mappingSize = 0;
+    ownedOffsets.clear();
+    ownedTargets.clear();
+    ownedWeights.clear();
+    n = 0;
+    m = 0;
+    minW = numeric_limits<int>::max();
+    maxW = 0;
+    offsets = nullptr;
+    targets = nullptr;
+    weights = nullptr;
+}
+
+vector<int> CsrGraph::dijkstra(int src, int dest, QueuePolicy policy) const {
+    return dijkstraPath(*this, src, dest, policy);
+}
+
+vector<int> CsrGraph::bidirectionalDijkstra(int src, int dest) const {
+    return bidirectionalPath(*this, src, dest);
+}
+
+const vector<int>& CsrGraph::dijkstra(int src, int dest, SearchWorkspace &workspace, QueuePolicy policy) const {
+    return dijkstraPath(*this, src, dest, policy, workspace);
+}
+
+const vector<int>& CsrGraph::bidirectionalDijkstra(int src, int dest, SearchWorkspace &workspace) const {
+    return bidirectionalPath(*this, src, dest, workspace);
+}
+
+bool CsrGraph::save(const string &fileName) const {
+    FILE *file = fopen(fileName.c_str(), "wb");
+    if (!file) {
+        cerr << "Error opening file: " << fileName << endl;
+        return false;
+    }
+
+    int32_t bounds[2] = { minW, maxW };
+    uint32_t reserved = 0;
+    uint64_t nodes = n, edges = m;
+    bool ok = fwrite(CSR_MAGIC, 1, sizeof(CSR_MAGIC), file) == sizeof(CSR_MAGIC)
+        && fwrite(bounds, sizeof(int32_t), 2, file) == 2
+        && fwrite(&reserved, sizeof(reserved), 1, file) == 1
+        && fwrite(&nodes, sizeof(nodes), 1, file) == 1
+        && fwrite(&edges, sizeof(edges), 1, file) == 1;
+    if (ok && offsets != nullptr) {
+        ok = fwrite(offsets, sizeof(uint64_t), n + 1, file) == static_cast<size_t>(n) + 1
+            && fwrite(targets, sizeof(int32_t), m, file) == m
+            && fwrite(weights, sizeof(int32_t), m, file) == m;
+    }
+    ok = fclose(file) == 0 && ok;
+
+    if (!ok) cerr << "Error writing file: " << fileName << endl;
+    return ok;
+}
+
+// Function to check that offsets are monotonic and every target is a node
+bool CsrGraph::checkEdges() const {
+    if (offsets[0] != 0 || offsets[n] != m) return false;
+    for (int u = 0; u < n; ++u) {
+        if (offsets[u] > offsets[u + 1]) return false;
+    }
+    for (size_t e = 0; e < m; ++e) {
+        if (targets[e] < 0 || targets[e] >= n) return false;
+    }
+    return true;
+}
+
+bool CsrGraph::load(const string &fileName, bool verify) {
+    release();
+
+    FILE *file = fopen(fileName.c_str(), "rb");
+    if (!file) {
+        cerr << "Error opening file: " << fileName << endl;
+        return false;
+    }
+
+    char magic[4];
+    int32_t bounds[2];
+    uint32_t reserved;
+    uint64_t nodes, edges;
+    bool ok = fread(magic, 1, sizeof(magic), file) == sizeof(magic)
+        && fread(bounds, sizeof(int32_t), 2, file) == 2
+        && fread(&reserved, sizeof(reserved), 1, file) == 1
+        && fread(&nodes, sizeof(nodes), 1, file) == 1
+        && fread(&edges, sizeof(edges), 1, file) == 1
+        && memcmp(magic, CSR_MAGIC, sizeof(magic)) == 0
+        && nodes < static_cast<uint64_t>(numeric_limits<int>::max());
+
+    // Bound both counts by the file size before multiplying, so a corrupt
+    // header cannot wrap the expected size round to the real one
+    uint64_t size = 0;
+    ok = ok && fileSize(file, size) && size >= CSR_HEADER_SIZE;
+    uint64_t body = ok ? size - CSR_HEADER_SIZE : 0;
+    ok = ok && nodes < body / sizeof(uint64_t) && edges <= body / (2 * sizeof(int32_t))
+        && (nodes + 1) * sizeof(uint64_t) + edges * 2 * sizeof(int32_t) == body;
+    size_t expected = ok ? static_cast<size_t>(size) : 0;
+
+#ifndef _WIN32
+    if (ok) {
+        void *data = mmap(nullptr, expected, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+        if (data != MAP_FAILED) {
+            mapping = data;
+            mappingSize = expected;
+            const uint8_t *base = static_cast<const uint8_t*>(data) + CSR_HEADER_SIZE;
+            offsets = reinterpret_cast<const uint64_t*>(base);
+            targets = reinterpret_cast<const int32_t*>(base + (nodes + 1) * sizeof(uint64_t));
+            weights = targets + edges;
+        }
+    }
+#endif
+
+    if (ok && mapping == nullptr) {
+        // No mapping available: read the arrays into owned storage
+        ownedOffsets.resize(nodes + 1);
+        ownedTargets.resize(edges);
+        ownedWeights.resize(edges);
+        ok = fread(ownedOffsets.data(), sizeof(uint64_t), nodes + 1, file) == nodes + 1
+            && fread(ownedTargets.data(), sizeof(int32_t), edges, file) == edges
+            && fread(ownedWeights.data(), sizeof(int32_t), edges, file) == edges;
+        offsets = ownedOffsets.data();
+        targets = ownedTargets.data();
+        weights = ownedWeights.data();
+    }
+    fclose(file);
+
+    if (ok) {
+        n = static_cast<int>(nodes);
+        m = edges;
+        minW = bounds[0];
+        maxW = bounds[1];
+        ok = offsets[0] == 0 && offsets[n] == m && (!verify || checkEdges());
+    }
+    if (!ok) {
+        cerr << "Invalid graph file: " << fileName << endl;
+        release();
+    }
+    return ok;
+}
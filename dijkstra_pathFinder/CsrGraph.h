@@ -0,0 +1,93 @@
+#ifndef CSRGRAPH_H
+#define CSRGRAPH_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "Graph.h"
+
+using namespace std;
+
+// Immutable compressed sparse row form of a Graph: the edges of node u are
+// targets[offsets[u] .. offsets[u + 1]) with matching weights, stored as
+// separate arrays so relaxing a node reads sequential memory. Build one
+// from a Graph once edits are done, or load a file written by save().
+//
+// File layout (native byte order):
+//   "CSR1" | i32 minWeight | i32 maxWeight | u32 0 | u64 nodes | u64 edges |
+//   u64 offsets[nodes + 1] | i32 targets[edges] | i32 weights[edges]
+class CsrGraph {
+public:
+    CsrGraph() = default;
+    explicit CsrGraph(const Graph &graph);
+    ~CsrGraph();
+    CsrGraph(const CsrGraph&) = delete;
+    CsrGraph& operator=(const CsrGraph&) = delete;
+
+    int size() const { return n; }
+    size_t edgeCount() const { return m; }
+    int minWeight() const { return minW; }
+    int maxWeight() const { return maxW; }
+    uint64_t edgeBegin(int u) const { return offsets[u]; }
+    uint64_t edgeEnd(int u) const { return offsets[u + 1]; }
+    int target(uint64_t e) const { return targets[e]; }
+    int weight(uint64_t e) const { return weights[e]; }
+
+    template <typename F>
+    void forEachEdge(int u, F f) const {
+        for (uint64_t e = offsets[u], end = offsets[u + 1]; e < end; ++e) f(targets[e], weights[e]);
+    }
+
+    vector<int> dijkstra(int src, int dest, QueuePolicy policy = QUEUE_AUTO) const;
+    vector<int> bidirectionalDijkstra(int src, int dest) const;
+
+    template <typename H>
+    vector<int> astar(int src, int dest, const H &heuristic) const {
+        return astarPath(*this, src, dest, heuristic);
+    }
+
+    // Same searches reusing a workspace's buffers; the returned path lives
+    // in the workspace until its next query
+    const vector<int>& dijkstra(int src, int dest, SearchWorkspace &workspace, QueuePolicy policy = QUEUE_AUTO) const;
+    const vector<int>& bidirectionalDijkstra(int src, int dest, SearchWorkspace &workspace) const;
+
+    template <typename H>
+    const vector<int>& astar(int src, int dest, const H &heuristic, SearchWorkspace &workspace) const {
+        return astarPath(*this, src, dest, heuristic, workspace);
+    }
+
+    // Full distances and predecessors from src (no early exit), computed in
+    // parallel by delta-stepping; delta is the bucket width, 0 picks one
+    void deltaStepping(int src, vector<int> &dist, vector<int> &prev, WorkStealingPool &pool, int delta = 0) const {
+        deltaSteppingPaths(*this, src, dist, prev, pool, delta);
+    }
+
+    bool save(const string &fileName) const;
+
+    // Maps the file where possible, so loading costs no parsing or copying.
+    // With verify set, every offset and target is range-checked as well.
+    bool load(const string &fileName, bool verify = false);
+
+private:
+    void release();
+    bool checkEdges() const;
+
+    int n = 0;
+    size_t m = 0;
+    int minW = numeric_limits<int>::max();
+    int maxW = 0;
+    const uint64_t *offsets = nullptr;
+    const int32_t *targets = nullptr;
+    const int32_t *weights = nullptr;
+
+    // Storage for built graphs, or for files read without a mapping
+    vector<uint64_t> ownedOffsets;
+    vector<int32_t> ownedTargets;
+    vector<int32_t> ownedWeights;
+
+    void *mapping = nullptr;
+    size_t mappingSize = 0;
+};
+
+#endif
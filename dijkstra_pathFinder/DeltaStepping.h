@@ -0,0 +1,188 @@
+#ifndef DELTASTEPPING_H
+#define DELTASTEPPING_H
+
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+#include "SearchWorkspace.h"
+#include "WorkStealingPool.h"
+
+using namespace std;
+
+// Parallel single-source shortest paths by delta-stepping (Meyer and
+// Sanders). Nodes are kept in buckets of width delta by tentative distance.
+// The lowest bucket is emptied in rounds: every node in it relaxes its light
+// edges (weight <= delta) in parallel, which may refill that same bucket,
+// until it stays empty; then its nodes relax their heavy edges once, which
+// can only reach later buckets. A small delta approaches Dijkstra (little
+// wasted work, little parallelism), a large one Bellman-Ford.
+//
+// Works on any graph G accepted by PathSearch.h. Whole frontier rounds run
+// on the pool; distances settle through compare-and-swap on one 64-bit word
+// per node holding distance and predecessor, so each pair stays consistent.
+// Distances match Dijkstra exactly; among equally short paths, which
+// predecessor a node keeps depends on thread timing.
+
+// Nodes per pool task when splitting a round; smaller rounds run inline
+const size_t DELTA_STEPPING_GRAIN = 256;
+
+// Function to pick a bucket width: about the largest weight over the
+// average degree, so a bucket's light edges rarely pass it
+template <typename G>
+int chooseDelta(const G &graph) {
+    size_t edges = 0;
+    for (int u = 0; u < graph.size(); ++u) graph.forEachEdge(u, [&](int, int) { edges++; });
+    if (edges == 0) return 1;
+
+    long long delta = static_cast<long long>(graph.maxWeight()) * graph.size() / static_cast<long long>(edges);
+    return static_cast<int>(max(1LL, min(delta, static_cast<long long>(graph.maxWeight()))));
+}
+
+template <typename G>
+class DeltaStepping {
+public:
+    DeltaStepping(const G &graph, WorkStealingPool &pool, int delta)
+        : graph(graph), pool(pool), delta(delta > 0 ? delta : chooseDelta(graph)), n(graph.size()),
+          labels(new atomic<uint64_t>[graph.size()]), changed(pool.size()) {}
+
+    void run(int src, vector<int> &dist, vector<int> &prev) {
+        for (int u = 0; u < n; ++u) labels[u].store(pack(INF_DIST, -1), memory_order_relaxed);
+
+        // Relaxing a node reaches at most maxWeight / delta buckets ahead
+        size_t ring = static_cast<size_t>(max(graph.maxWeight(), 0) / delta) + 2;
+        buckets.assign(ring, {});
+        vector<int> round, settled;
+        vector<int> inRound(n, -1), inSettled(n, -1);
+        int rounds = 0;
+
+        labels[src].store(pack(0, -1), memory_order_relaxed);
+        buckets[0].push_back(src);
+        queued = 1;
+
+        for (int i = 0; queued > 0; ++i) {
+            vector<int> &bucket = buckets[i % ring];
+            settled.clear();
+            while (!bucket.empty()) {
+                // Drop stale entries and duplicates, keeping nodes whose
+                // distance still falls in this bucket
+                round.clear();
+                for (int u : bucket) {
+                    if (distOf(u) / delta != i || inRound[u] == rounds) continue;
+                    inRound[u] = rounds;
+                    round.push_back(u);
+                    if (inSettled[u] != i) {
+                        inSettled[u] = i;
+                        settled.push_back(u);
+                    }
+                }
+                queued -= bucket.size();
+                bucket.clear();
+                rounds++;
+
+                relax(round, true);
+                requeue(ring);
+            }
+
+            relax(settled, false);
+            requeue(ring);
+        }
+
+        dist.resize(n);
+        prev.resize(n);
+        for (int u = 0; u < n; ++u) {
+            uint64_t label = labels[u].load(memory_order_relaxed);
+            dist[u] = static_cast<int>(label >> 32);
+            prev[u] = static_cast<int32_t>(static_cast<uint32_t>(label));
+        }
+    }
+
+private:
+    static uint64_t pack(int d, int p) {
+        return static_cast<uint64_t>(static_cast<uint32_t>(d)) << 32 | static_cast<uint32_t>(p);
+    }
+
+    int distOf(int u) const {
+        return static_cast<int>(labels[u].load(memory_order_relaxed) >> 32);
+    }
+
+    // Function to relax the light or the heavy edges of every node in `nodes`,
+    // recording the nodes whose distance dropped in `changed`
+    void relax(const vector<int> &nodes, bool light) {
+        size_t tasks = (nodes.size() + DELTA_STEPPING_GRAIN - 1) / DELTA_STEPPING_GRAIN;
+        auto task = [&](size_t t, unsigned worker) {
+            size_t end = min(nodes.size(), (t + 1) * DELTA_STEPPING_GRAIN);
+            for (size_t k = t * DELTA_STEPPING_GRAIN; k < end; ++k) {
+                int u = nodes[k];
+                int d = distOf(u);
+                graph.forEachEdge(u, [&](int v, int weight) {
+                    if ((weight <= delta) != light) return;
+                    // Only a strictly shorter distance replaces a label:
+                    // switching predecessors on ties could close a cycle
+                    // of zero-weight edges
+                    uint64_t candidate = pack(d + weight, u);
+                    uint64_t current = labels[v].load(memory_order_relaxed);
+                    while ((candidate >> 32) < (current >> 32)) {
+                        if (labels[v].compare_exchange_weak(current, candidate, memory_order_relaxed)) {
+                            changed[worker].push_back(v);
+                            break;
+                        }
+                    }
+                });
+            }
+        };
+
+        if (tasks <= 1) {
+            if (tasks == 1) task(0, 0);
+        } else {
+            pool.run(tasks, task);
+        }
+    }
+
+    // Function to move the nodes relaxed in the last round into their buckets
+    void requeue(size_t ring) {
+        for (vector<int> &nodes : changed) {
+            for (int v : nodes) buckets[(distOf(v) / delta) % ring].push_back(v);
+            queued += nodes.size();
+            nodes.clear();
+        }
+    }
+
+    const G &graph;
+    WorkStealingPool &pool;
+    int delta;
+    int n;
+    unique_ptr<atomic<uint64_t>[]> labels;
+    vector<vector<int>> changed;
+    vector<vector<int>> buckets;
+    size_t queued = 0;
+};
+
+// Function to compute full distance and predecessor arrays from src with
+// delta-stepping on the pool; delta <= 0 picks the bucket width
+template <typename G>
+void deltaSteppingPaths(const G &graph, int src, vector<int> &dist, vector<int> &prev, WorkStealingPool &pool, int delta = 0) {
+    DeltaStepping<G> search(graph, pool, delta);
+    search.run(src, dist, prev);
+}
+
+// Function to check dist/prev as a shortest path tree from src: no edge can
+// shorten any distance and every predecessor edge is tight. Costs one pass
+// over the edges, far less than the search it checks.
+template <typename G>
+bool checkShortestPaths(const G &graph, int src, const vector<int> &dist, const vector<int> &prev) {
+    if (dist[src] != 0 || prev[src] != -1) return false;
+    for (int u = 0; u < graph.size(); ++u) {
+        bool tight = u == src || (dist[u] == INF_DIST && prev[u] == -1);
+        bool ok = true;
+        graph.forEachEdge(u, [&](int v, int weight) {
+            if (dist[u] != INF_DIST && dist[u] + weight < dist[v]) ok = false;
+            if (v == prev[u] && dist[v] != INF_DIST && dist[v] + weight == dist[u]) tight = true;
+        });
+        if (!ok || !tight) return false;
+    }
+    return true;
+}
+
+#endif
@@ -1,43 +1,78 @@
 #include "Graph.h"
+#include <algorithm>
 
 Graph::Graph(int n) : n(n), adj(n) {}
 
+void Graph::noteWeight(int w) {
+    minW = min(minW, w);
+    maxW = max(maxW, w);
+}
+
 void Graph::addEdge(int u, int v, int w) {
+    noteWeight(w);
     adj[u].emplace_back(v, w);
     adj[v].emplace_back(u, w);
 }
 
-vector<int> Graph::dijkstra(int src, int dest) {
-    vector<int> dist(n, numeric_limits<int>::max());
-    vector<int> prev(n, -1);
-    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
-    vector<int> path;
+// Function to drop v from u's adjacency list, returning false if absent
+static bool unlink(vector<pair<int, int>> &list, int v) {
+    for (size_t i = 0; i < list.size(); ++i) {
+        if (list[i].first == v) {
+            list[i] = list.back();
+            list.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
 
-    dist[src] = 0;
-    pq.emplace(0, src);
+bool Graph::removeEdge(int u, int v) {
+    bool found = unlink(adj[u], v);
+    unlink(adj[v], u);
+    return found;
+}
 
-    while (!pq.empty()) {
-        int u = pq.top().second;
-        pq.pop();
+bool Graph::setEdgeWeight(int u, int v, int w) {
+    noteWeight(w);
+    bool found = false;
+    for (auto &neighbor : adj[u]) {
+        if (neighbor.first == v) {
+            neighbor.second = w;
+            found = true;
+        }
+    }
+    for (auto &neighbor : adj[v]) {
+        if (neighbor.first == u) neighbor.second = w;
+    }
+    return found;
+}
 
-        if (u == dest) break;
+// Function to remove every edge touching u
+void Graph::clearEdges(int u) {
+    for (const auto &neighbor : adj[u]) {
+        if (neighbor.first != u) unlink(adj[neighbor.first], u);
+    }
+    adj[u].clear();
+}
 
-        for (const auto &neighbor : adj[u]) {
-            int v = neighbor.first;
-            int weight = neighbor.second;
+void Graph::clear() {
+    for (auto &list : adj) list.clear();
+    minW = numeric_limits<int>::max();
+    maxW = 0;
+}
 
-            if (dist[u] + weight < dist[v]) {
-                dist[v] = dist[u] + weight;
-                prev[v] = u;
-                pq.emplace(dist[v], v);
-            }
-        }
-    }
+vector<int> Graph::dijkstra(int src, int dest, QueuePolicy policy) const {
+    return dijkstraPath(*this, src, dest, policy);
+}
+
+vector<int> Graph::bidirectionalDijkstra(int src, int dest) const {
+    return bidirectionalPath(*this, src, dest);
+}
 
-    for (int at = dest; at != -1; at = prev[at])
-        path.push_back(at);
-    
-    reverse(path.begin(), path.end());
+const vector<int>& Graph::dijkstra(int src, int dest, SearchWorkspace &workspace, QueuePolicy policy) const {
+    return dijkstraPath(*this, src, dest, policy, workspace);
+}
 
-    return path;
+const vector<int>& Graph::bidirectionalDijkstra(int src, int dest, SearchWorkspace &workspace) const {
+    return bidirectionalPath(*this, src, dest, workspace);
 }
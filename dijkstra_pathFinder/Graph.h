@@ -5,17 +5,63 @@
 #include <utility>
 #include <limits>
 #include <queue>
-#include <SFML/Graphics.hpp>
+#include "PathSearch.h"
+#include "DeltaStepping.h"
 
 using namespace std;
 
+// Undirected weighted graph stored as adjacency lists
 class Graph {
 public:
     Graph(int n);
+    int size() const { return n; }
+
+    // Bounds on the weights of edges added since the last clear(); edges
+    // removed or reweighted since do not narrow them
+    int minWeight() const { return minW; }
+    int maxWeight() const { return maxW; }
+    const vector<pair<int, int>>& neighbors(int u) const { return adj[u]; }
+
+    template <typename F>
+    void forEachEdge(int u, F f) const {
+        for (const auto &neighbor : adj[u]) f(neighbor.first, neighbor.second);
+    }
+
     void addEdge(int u, int v, int w);
-    vector<int> dijkstra(int src, int dest);
+    bool removeEdge(int u, int v);
+    bool setEdgeWeight(int u, int v, int w);
+    void clearEdges(int u);
+    void clear();
+
+    vector<int> dijkstra(int src, int dest, QueuePolicy policy = QUEUE_AUTO) const;
+    vector<int> bidirectionalDijkstra(int src, int dest) const;
+
+    template <typename H>
+    vector<int> astar(int src, int dest, const H &heuristic) const {
+        return astarPath(*this, src, dest, heuristic);
+    }
+
+    // Same searches reusing a workspace's buffers; the returned path lives
+    // in the workspace until its next query
+    const vector<int>& dijkstra(int src, int dest, SearchWorkspace &workspace, QueuePolicy policy = QUEUE_AUTO) const;
+    const vector<int>& bidirectionalDijkstra(int src, int dest, SearchWorkspace &workspace) const;
+
+    template <typename H>
+    const vector<int>& astar(int src, int dest, const H &heuristic, SearchWorkspace &workspace) const {
+        return astarPath(*this, src, dest, heuristic, workspace);
+    }
+
+    // Full distances and predecessors from src (no early exit), computed in
+    // parallel by delta-stepping; delta is the bucket width, 0 picks one
+    void deltaStepping(int src, vector<int> &dist, vector<int> &prev, WorkStealingPool &pool, int delta = 0) const {
+        deltaSteppingPaths(*this, src, dist, prev, pool, delta);
+    }
 private:
+    void noteWeight(int w);
+
     int n;
+    int minW = numeric_limits<int>::max();
+    int maxW = 0;
     vector<vector<pair<int, int>>> adj;
 };
 
@@ -0,0 +1,137 @@
+#include "GridGraph.h"
+#include "Heuristics.h"
+#include <algorithm>
+
+GridGraph::GridGraph(int width, int height, bool diagonal)
+    : cols(width), rows(height), diagonals(diagonal), g(width * height), cellBlocked(width * height, false),
+      cellWeight(width * height, 1) {
+    clear();
+}
+
+bool GridGraph::open(int x, int y) const {
+    return x >= 0 && x < cols && y >= 0 && y < rows && !cellBlocked[node(x, y)];
+}
+
+int GridGraph::edgeWeight(int u, int v, bool diagonalStep) const {
+    int weight = max(cellWeight[u], cellWeight[v]);
+    if (!diagonals) return weight;
+    return weight * (diagonalStep ? GRID_DIAGONAL_COST : GRID_STRAIGHT_COST);
+}
+
+// Function to rebuild the edges between a cell and its neighbours
+void GridGraph::relink(int x, int y) {
+    int u = node(x, y);
+    g.clearEdges(u);
+
+    const int dx[] = { 0, 0, -1, 1, -1, 1, -1, 1 };
+    const int dy[] = { -1, 1, 0, 0, -1, -1, 1, 1 };
+    int directions = diagonals ? 8 : 4;
+    if (!cellBlocked[u]) {
+        for (int d = 0; d < directions; ++d) {
+            int nx = x + dx[d], ny = y + dy[d];
+            if (!open(nx, ny)) continue;
+            if (d >= 4 && (!open(nx, y) || !open(x, ny))) continue;
+            g.addEdge(u, node(nx, ny), edgeWeight(u, node(nx, ny), d >= 4));
+        }
+    }
+
+    // The cell is also a corner of the diagonals between its 4 neighbours
+    if (diagonals) {
+        relinkDiagonal(x - 1, y, x, y - 1);
+        relinkDiagonal(x, y - 1, x + 1, y);
+        relinkDiagonal(x + 1, y, x, y + 1);
+        relinkDiagonal(x, y + 1, x - 1, y);
+    }
+}
+
+// Function to re-check the diagonal between (x, y) and (nx, ny)
+void GridGraph::relinkDiagonal(int x, int y, int nx, int ny) {
+    if (x < 0 || x >= cols || y < 0 || y >= rows || nx < 0 || nx >= cols || ny < 0 || ny >= rows) return;
+    int u = node(x, y), v = node(nx, ny);
+    g.removeEdge(u, v);
+    if (open(x, y) && open(nx, ny) && open(nx, y) && open(x, ny)) g.addEdge(u, v, edgeWeight(u, v, true));
+}
+
+void GridGraph::setBlocked(int x, int y, bool blocked) {
+    int u = node(x, y);
+    if (cellBlocked[u] == blocked) return;
+    cellBlocked[u] = blocked;
+    relink(x, y);
+    edits++;
+    dirty = true;
+}
+
+void GridGraph::setWeight(int x, int y, int weight) {
+    int u = node(x, y);
+    if (cellWeight[u] == weight) return;
+    cellWeight[u] = weight;
+    minCellWeight = min(minCellWeight, weight);
+    relink(x, y);
+    edits++;
+    dirty = true;
+}
+
+// Function to open every cell with weight 1
+void GridGraph::clear() {
+    fill(cellBlocked.begin(), cellBlocked.end(), false);
+    fill(cellWeight.begin(), cellWeight.end(), 1);
+    rebuild();
+}
+
+void GridGraph::setTerrain(const vector<int> &weights) {
+    for (int u = 0; u < cols * rows; ++u) {
+        cellBlocked[u] = weights[u] <= 0;
+        cellWeight[u] = max(weights[u], 1);
+    }
+    rebuild();
+}
+
+// Function to link every pair of open neighbours, adding each edge once
+// from its upper or left end
+void GridGraph::rebuild() {
+    g.clear();
+    minCellWeight = *min_element(cellWeight.begin(), cellWeight.end());
+    for (int y = 0; y < rows; ++y) {
+        for (int x = 0; x < cols; ++x) {
+            if (!open(x, y)) continue;
+            int u = node(x, y);
+            if (open(x + 1, y)) g.addEdge(u, node(x + 1, y), edgeWeight(u, node(x + 1, y), false));
+            if (open(x, y + 1)) g.addEdge(u, node(x, y + 1), edgeWeight(u, node(x, y + 1), false));
+            if (!diagonals || !open(x, y + 1)) continue;
+            if (open(x + 1, y) && open(x + 1, y + 1)) g.addEdge(u, node(x + 1, y + 1), edgeWeight(u, node(x + 1, y + 1), true));
+            if (open(x - 1, y) && open(x - 1, y + 1)) g.addEdge(u, node(x - 1, y + 1), edgeWeight(u, node(x - 1, y + 1), true));
+        }
+    }
+    edits++;
+    dirty = true;
+}
+
+// Every step costs at least its factor times the cheapest cell weight;
+// 4-connected this is the Manhattan distance
+OctileHeuristic GridGraph::heuristic(int dest) const {
+    int cheapest = max(minCellWeight, 0);
+    if (!diagonals) return OctileHeuristic(cols, dest, cheapest, 2 * cheapest);
+    return OctileHeuristic(cols, dest, cheapest * GRID_STRAIGHT_COST, cheapest * GRID_DIAGONAL_COST);
+}
+
+void GridGraph::setSearchMode(SearchMode searchMode) {
+    if (mode == searchMode) return;
+    mode = searchMode;
+    dirty = true;
+}
+
+const vector<int>& GridGraph::shortestPath(int src, int dest) {
+    if (dirty || src != pathSrc || dest != pathDest) {
+        if (mode == SEARCH_ASTAR) {
+            path = g.astar(src, dest, heuristic(dest), workspace);
+        } else if (mode == SEARCH_BIDIRECTIONAL) {
+            path = g.bidirectionalDijkstra(src, dest, workspace);
+        } else {
+            path = g.dijkstra(src, dest, workspace);
+        }
+        pathSrc = src;
+        pathDest = dest;
+        dirty = false;
+    }
+    return path;
+}
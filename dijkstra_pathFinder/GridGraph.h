@@ -0,0 +1,83 @@
+#ifndef GRIDGRAPH_H
+#define GRIDGRAPH_H
+
+#include "Graph.h"
+#include "Heuristics.h"
+
+// How GridGraph routes between two cells
+enum SearchMode {
+    SEARCH_DIJKSTRA,
+    SEARCH_ASTAR,         // A* with the Manhattan (or, 8-connected, octile) distance
+    SEARCH_BIDIRECTIONAL
+};
+
+// Step costs of an 8-connected grid, close to 1 : sqrt(2)
+const int GRID_STRAIGHT_COST = 10;
+const int GRID_DIAGONAL_COST = 14;
+
+// 4- or 8-connected grid kept as a Graph that is updated in place. Edits
+// only relink the edges around the changed cell, and the route is
+// recomputed only after an edit or a change of endpoints, so per-frame cost
+// and memory stay flat however long the grid is used.
+//
+// Every open cell has a weight (default 1); the edge between two open
+// neighbours costs the larger of their weights. With diagonals the edge
+// cost is also multiplied by GRID_STRAIGHT_COST or GRID_DIAGONAL_COST, and
+// a diagonal step needs both cells beside it open, so paths never cut
+// the corner of an obstacle.
+class GridGraph {
+public:
+    GridGraph(int width, int height, bool diagonal = false);
+
+    int width() const { return cols; }
+    int height() const { return rows; }
+    int node(int x, int y) const { return y * cols + x; }
+    bool blocked(int x, int y) const { return cellBlocked[node(x, y)]; }
+    int weight(int x, int y) const { return cellWeight[node(x, y)]; }
+    bool diagonal() const { return diagonals; }
+    const Graph& graph() const { return g; }
+
+    // Count of changes to graph() so far, to tell whether a copy is current
+    unsigned long revision() const { return edits; }
+
+    void setBlocked(int x, int y, bool blocked);
+    void setWeight(int x, int y, int weight);
+    void clear();
+
+    // Function to replace every cell at once, e.g. from a loaded map: row by
+    // row, a weight of 0 or less blocks the cell. Rebuilds the graph in one
+    // pass instead of relinking cell by cell.
+    void setTerrain(const vector<int> &weights);
+
+    // Admissible A* bound towards dest for the current weights
+    OctileHeuristic heuristic(int dest) const;
+
+    SearchMode searchMode() const { return mode; }
+    void setSearchMode(SearchMode searchMode);
+
+    // Shortest path between two nodes in the current search mode, in the
+    // format Graph::dijkstra returns
+    const vector<int>& shortestPath(int src, int dest);
+private:
+    void relink(int x, int y);
+    void relinkDiagonal(int x, int y, int nx, int ny);
+    bool open(int x, int y) const;
+    int edgeWeight(int u, int v, bool diagonalStep) const;
+    void rebuild();
+
+    int cols, rows;
+    bool diagonals;
+    Graph g;
+    vector<bool> cellBlocked;
+    vector<int> cellWeight;
+    int minCellWeight = 1; // lower bound on cellWeight since the last rebuild
+    unsigned long edits = 0;
+
+    SearchMode mode = SEARCH_ASTAR;
+    bool dirty = true;
+    int pathSrc = -1, pathDest = -1;
+    vector<int> path;
+    SearchWorkspace workspace;
+};
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef HEURISTICS_H
+#define HEURISTICS_H
+
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+
+using namespace std;
+
+// Lower bounds on the remaining distance to a fixed destination, for A*.
+// Each is admissible as long as `scale` (or the step costs) is no more than
+// the cheapest edge weight of the matching kind.
+
+// 4-connected grids: node = y * width + x
+struct ManhattanHeuristic {
+    int width, destX, destY, scale;
+
+    ManhattanHeuristic(int width, int dest, int scale = 1)
+        : width(width), destX(dest % width), destY(dest / width), scale(scale) {}
+
+    int operator()(int u) const {
+        return scale * (abs(u % width - destX) + abs(u / width - destY));
+    }
+};
+
+// 8-connected grids, where a straight step costs `straight` and a diagonal
+// step costs `diagonal`
+struct OctileHeuristic {
+    int width, destX, destY, straight, diagonal;
+
+    OctileHeuristic(int width, int dest, int straight = 1, int diagonal = 1)
+        : width(width), destX(dest % width), destY(dest / width), straight(straight), diagonal(diagonal) {}
+
+    int operator()(int u) const {
+        int dx = abs(u % width - destX);
+        int dy = abs(u / width - destY);
+        return straight * (dx + dy) + (diagonal - 2 * straight) * min(dx, dy);
+    }
+};
+
+// Graphs with node coordinates, whose edge weights are at least `scale`
+// times the straight-line distance between their ends
+struct EuclideanHeuristic {
+    const vector<double> *xs, *ys;
+    double destX, destY, scale;
+
+    EuclideanHeuristic(const vector<double> &x, const vector<double> &y, int dest, double scale = 1)
+        : xs(&x), ys(&y), destX(x[dest]), destY(y[dest]), scale(scale) {}
+
+    int operator()(int u) const {
+        return static_cast<int>(scale * hypot((*xs)[u] - destX, (*ys)[u] - destY));
+    }
+};
+
+#endif
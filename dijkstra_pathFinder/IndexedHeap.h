@@ -0,0 +1,102 @@
+#ifndef INDEXEDHEAP_H
+#define INDEXEDHEAP_H
+
+#include <vector>
+
+using namespace std;
+
+// Indexed 4-ary min-heap of nodes keyed by distance, with true decrease-key:
+// every node is in the heap at most once, so it never holds more than n
+// entries. A 4-ary heap is shallower than a binary one and keeps each
+// node's children in one cache line.
+class IndexedHeap {
+public:
+    static const int ARITY = 4;
+
+    // Empties the heap for nodes 0..n-1; costs only the entries still queued
+    void reset(int n) {
+        for (const Entry &entry : heap) pos[entry.node] = -1;
+        heap.clear();
+        if (static_cast<int>(pos.size()) < n) pos.resize(n, -1);
+    }
+
+    bool empty() const { return heap.empty(); }
+    bool contains(int node) const { return pos[node] >= 0; }
+
+    // Inserts node, or lowers its key if it is already queued
+    void push(int node, int key) {
+        if (pos[node] < 0) {
+            pos[node] = heap.size();
+            heap.push_back({ key, node });
+        } else {
+            heap[pos[node]].key = key;
+        }
+        siftUp(pos[node]);
+    }
+
+    int topKey() const { return heap[0].key; }
+
+    // Calls f(node) for every queued node, in no particular order
+    template <typename F>
+    void forEachNode(F f) const {
+        for (const Entry &entry : heap) f(entry.node);
+    }
+
+    int pop() {
+        int node = heap[0].node;
+        pos[node] = -1;
+        Entry last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            heap[0] = last;
+            pos[last.node] = 0;
+            siftDown(0);
+        }
+        return node;
+    }
+
+private:
+    struct Entry {
+        int key;
+        int node;
+    };
+
+    void place(int i, const Entry &entry) {
+        heap[i] = entry;
+        pos[entry.node] = i;
+    }
+
+    void siftUp(int i) {
+        Entry entry = heap[i];
+        while (i > 0) {
+            int parent = (i - 1) / ARITY;
+            if (heap[parent].key <= entry.key) break;
+            place(i, heap[parent]);
+            i = parent;
+        }
+        place(i, entry);
+    }
+
+    void siftDown(int i) {
+        Entry entry = heap[i];
+        int size = heap.size();
+        while (true) {
+            int first = i * ARITY + 1;
+            if (first >= size) break;
+            int best = first;
+            int last = first + ARITY < size ? first + ARITY : size;
+            for (int c = first + 1; c < last; ++c) {
+                if (heap[c].key < heap[best].key) best = c;
+            }
+            if (heap[best].key >= entry.key) break;
+            place(i, heap[best]);
+            i = best;
+        }
+        place(i, entry);
+    }
+
+    vector<Entry> heap;
+    vector<int> pos;
+};
+
+#endif
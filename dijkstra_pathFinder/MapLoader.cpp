@@ -0,0 +1,81 @@
+#include "MapLoader.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cctype>
+
+// Function to read the next header number, skipping whitespace and comments
+static bool readHeaderValue(istream &in, int &value) {
+    while (true) {
+        int c = in.peek();
+        if (c == '#') {
+            string comment;
+            getline(in, comment);
+        } else if (isspace(c)) {
+            in.get();
+        } else {
+            break;
+        }
+    }
+    return static_cast<bool>(in >> value);
+}
+
+bool loadPgm(const string &fileName, int &width, int &height, vector<uint8_t> &pixels) {
+    ifstream in(fileName, ios::binary);
+    if (!in) {
+        cerr << "Error opening file: " << fileName << endl;
+        return false;
+    }
+
+    string magic;
+    int maxValue = 0;
+    in >> magic;
+    if ((magic != "P2" && magic != "P5") || !readHeaderValue(in, width) || !readHeaderValue(in, height)
+        || !readHeaderValue(in, maxValue) || width <= 0 || height <= 0 || maxValue <= 0 || maxValue > 65535) {
+        cerr << "Not a PGM image: " << fileName << endl;
+        return false;
+    }
+
+    size_t cells = static_cast<size_t>(width) * height;
+    pixels.resize(cells);
+    if (magic == "P2") {
+        for (size_t i = 0; i < cells; ++i) {
+            int level;
+            if (!(in >> level)) {
+                cerr << "Truncated PGM image: " << fileName << endl;
+                return false;
+            }
+            pixels[i] = static_cast<uint8_t>(min(max(level, 0), maxValue) * 255 / maxValue);
+        }
+        return true;
+    }
+
+    // One whitespace byte ends the header; samples are 1 byte, or 2 bytes
+    // big-endian when maxValue exceeds 255
+    in.get();
+    int sampleSize = maxValue > 255 ? 2 : 1;
+    vector<uint8_t> raw(cells * sampleSize);
+    if (!in.read(reinterpret_cast<char*>(raw.data()), raw.size())) {
+        cerr << "Truncated PGM image: " << fileName << endl;
+        return false;
+    }
+    for (size_t i = 0; i < cells; ++i) {
+        int level = sampleSize == 1 ? raw[i] : (raw[2 * i] << 8) | raw[2 * i + 1];
+        pixels[i] = static_cast<uint8_t>(min(level, maxValue) * 255 / maxValue);
+    }
+    return true;
+}
+
+vector<int> terrainWeights(const vector<uint8_t> &pixels) {
+    vector<int> weights(pixels.size());
+    for (size_t i = 0; i < pixels.size(); ++i) {
+        int level = pixels[i];
+        if (level <= MAP_OBSTACLE_LEVEL) {
+            weights[i] = 0;
+        } else {
+            // Linear from 1 at white to MAP_MAX_TERRAIN_WEIGHT just above the obstacle level
+            weights[i] = 1 + (255 - level) * (MAP_MAX_TERRAIN_WEIGHT - 1) / (255 - MAP_OBSTACLE_LEVEL - 1);
+        }
+    }
+    return weights;
+}
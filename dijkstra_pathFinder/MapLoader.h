@@ -0,0 +1,22 @@
+#ifndef MAPLOADER_H
+#define MAPLOADER_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+using namespace std;
+
+// Occupancy maps as grey levels, one byte per cell, row by row: dark
+// pixels are obstacles and lighter ones cheaper terrain
+const int MAP_OBSTACLE_LEVEL = 50;   // at or below: blocked
+const int MAP_MAX_TERRAIN_WEIGHT = 8; // weight of the darkest open cell; white costs 1
+
+// Function to read a PGM image, plain (P2) or binary (P5); levels above 255
+// are scaled down to 0..255
+bool loadPgm(const string &fileName, int &width, int &height, vector<uint8_t> &pixels);
+
+// Function to turn grey levels into GridGraph::setTerrain weights
+vector<int> terrainWeights(const vector<uint8_t> &pixels);
+
+#endif
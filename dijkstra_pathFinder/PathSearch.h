@@ -0,0 +1,350 @@
+#ifndef PATHSEARCH_H
+#define PATHSEARCH_H
+
+#include <vector>
+#include <utility>
+#include <limits>
+#include <algorithm>
+#include <functional>
+#include "SearchWorkspace.h"
+
+using namespace std;
+
+// Shortest path searches shared by every graph representation. A graph G
+// needs size(), forEachEdge(u, f), which calls f(v, w) for each edge
+// u -> v of weight w, and minWeight()/maxWeight() bounds on its weights.
+// Every search keeps its state in a SearchWorkspace, so repeated queries
+// allocate nothing; the overloads without one use a temporary workspace.
+
+// Priority queue used by dijkstra
+enum QueuePolicy {
+    QUEUE_AUTO,        // BFS for 0/1 weights, buckets for small weights, else the 4-ary heap
+    QUEUE_BINARY_HEAP, // binary heap with lazy insertion (the baseline)
+    QUEUE_DARY_HEAP,   // indexed 4-ary heap with decrease-key
+    QUEUE_BUCKETS,     // Dial's algorithm: one bucket per distance, for small integer weights
+    QUEUE_BFS          // breadth-first search; weights must be 0 or 1
+};
+
+// Largest weight QUEUE_AUTO hands to the bucket queue; the queue keeps one
+// bucket per possible distance in flight, maxWeight + 1 in all
+const int MAX_BUCKET_WEIGHT = 1024;
+
+// Function to follow prev links back from dest into `path`, which then runs
+// from the source to dest
+inline void tracePath(const SearchLabels &labels, int dest, vector<int> &path) {
+    path.clear();
+    for (int at = dest; at != -1; at = labels.prev(at))
+        path.push_back(at);
+
+    reverse(path.begin(), path.end());
+}
+
+template <typename G>
+QueuePolicy choosePolicy(const G &graph) {
+    if (graph.minWeight() < 0) return QUEUE_DARY_HEAP;
+    if (graph.maxWeight() <= 1) return QUEUE_BFS;
+    if (graph.maxWeight() <= MAX_BUCKET_WEIGHT) return QUEUE_BUCKETS;
+    return QUEUE_DARY_HEAP;
+}
+
+// Function to run Dijkstra with a lazy binary heap, skipping entries that
+// were superseded by a shorter distance
+template <typename G>
+void searchBinaryHeap(const G &graph, int src, int dest, SearchWorkspace &ws) {
+    SearchLabels &labels = ws.labels[0];
+    vector<pair<int, int>> &pq = ws.lazyHeap;
+    greater<pair<int, int>> later;
+    pq.clear();
+
+    labels.set(src, 0, -1);
+    pq.emplace_back(0, src);
+
+    while (!pq.empty()) {
+        int d = pq.front().first;
+        int u = pq.front().second;
+        pop_heap(pq.begin(), pq.end(), later);
+        pq.pop_back();
+
+        if (d != labels.dist(u)) continue;
+        if (u == dest) break;
+
+        graph.forEachEdge(u, [&](int v, int weight) {
+            if (d + weight < labels.dist(v)) {
+                labels.set(v, d + weight, u);
+                pq.emplace_back(d + weight, v);
+                push_heap(pq.begin(), pq.end(), later);
+            }
+        });
+    }
+}
+
+template <typename G>
+void searchDaryHeap(const G &graph, int src, int dest, SearchWorkspace &ws) {
+    SearchLabels &labels = ws.labels[0];
+    IndexedHeap &heap = ws.heap[0];
+    heap.reset(graph.size());
+
+    labels.set(src, 0, -1);
+    heap.push(src, 0);
+
+    while (!heap.empty()) {
+        int d = heap.topKey();
+        int u = heap.pop();
+        if (u == dest) break;
+
+        graph.forEachEdge(u, [&](int v, int weight) {
+            if (d + weight < labels.dist(v)) {
+                labels.set(v, d + weight, u);
+                heap.push(v, d + weight);
+            }
+        });
+    }
+}
+
+// Function to run Dial's algorithm: distances in flight never differ by more
+// than maxWeight, so maxWeight + 1 buckets used in a ring hold every queued
+// node, and each pop is a bucket scan instead of a heap operation. With
+// weights of 0 and 1 this is 0-1 BFS.
+template <typename G>
+void searchBuckets(const G &graph, int src, int dest, SearchWorkspace &ws) {
+    SearchLabels &labels = ws.labels[0];
+    size_t ring = static_cast<size_t>(max(graph.maxWeight(), 0)) + 1;
+    vector<vector<int>> &buckets = ws.buckets;
+    if (buckets.size() < ring) buckets.resize(ring);
+    for (size_t i = 0; i < ring; ++i) buckets[i].clear();
+
+    size_t queued = 1;
+    labels.set(src, 0, -1);
+    buckets[0].push_back(src);
+
+    for (int d = 0; queued > 0; ++d) {
+        vector<int> &bucket = buckets[d % ring];
+        // Nodes relaxed through a zero-weight edge land in this same bucket
+        for (size_t i = 0; i < bucket.size(); ++i) {
+            int u = bucket[i];
+            queued--;
+            if (labels.dist(u) != d) continue;
+            if (u == dest) return;
+
+            graph.forEachEdge(u, [&](int v, int weight) {
+                if (d + weight < labels.dist(v)) {
+                    labels.set(v, d + weight, u);
+                    buckets[(d + weight) % ring].push_back(v);
+                    queued++;
+                }
+            });
+        }
+        bucket.clear();
+    }
+}
+
+// Function to run breadth-first search: with unit weights the first time a
+// node is reached is the shortest, so a plain FIFO queue suffices. Zero
+// weights need 0-1 BFS, which is the bucket queue with two buckets.
+template <typename G>
+void searchBfs(const G &graph, int src, int dest, SearchWorkspace &ws) {
+    if (graph.minWeight() < 1) {
+        searchBuckets(graph, src, dest, ws);
+        return;
+    }
+
+    SearchLabels &labels = ws.labels[0];
+    vector<int> &queue = ws.queue;
+    queue.clear();
+
+    labels.set(src, 0, -1);
+    queue.push_back(src);
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int u = queue[head];
+        if (u == dest) return;
+        int d = labels.dist(u) + 1;
+        graph.forEachEdge(u, [&](int v, int) {
+            if (!labels.reached(v)) {
+                labels.set(v, d, u);
+                queue.push_back(v);
+            }
+        });
+    }
+}
+
+// Function to label nodes from src with the given queue policy, stopping
+// once dest is settled (pass -1 to settle every reachable node). Results
+// are in ws.labels[0].
+template <typename G>
+void shortestPaths(const G &graph, int src, int dest, QueuePolicy policy, SearchWorkspace &ws) {
+    ws.labels[0].reset(graph.size());
+
+    if (policy == QUEUE_AUTO) policy = choosePolicy(graph);
+    switch (policy) {
+        case QUEUE_BINARY_HEAP: searchBinaryHeap(graph, src, dest, ws); break;
+        case QUEUE_BUCKETS: searchBuckets(graph, src, dest, ws); break;
+        case QUEUE_BFS: searchBfs(graph, src, dest, ws); break;
+        default: searchDaryHeap(graph, src, dest, ws); break;
+    }
+}
+
+// Function to compute full distance and predecessor arrays from src
+template <typename G>
+void shortestPaths(const G &graph, int src, int dest, QueuePolicy policy, vector<int> &dist, vector<int> &prev) {
+    SearchWorkspace ws;
+    shortestPaths(graph, src, dest, policy, ws);
+
+    dist.resize(graph.size());
+    prev.resize(graph.size());
+    for (int u = 0; u < graph.size(); ++u) {
+        dist[u] = ws.labels[0].dist(u);
+        prev[u] = ws.labels[0].prev(u);
+    }
+}
+
+template <typename G>
+const vector<int>& dijkstraPath(const G &graph, int src, int dest, QueuePolicy policy, SearchWorkspace &ws) {
+    shortestPaths(graph, src, dest, policy, ws);
+    tracePath(ws.labels[0], dest, ws.path);
+    return ws.path;
+}
+
+template <typename G>
+vector<int> dijkstraPath(const G &graph, int src, int dest, QueuePolicy policy = QUEUE_AUTO) {
+    SearchWorkspace ws;
+    return dijkstraPath(graph, src, dest, policy, ws);
+}
+
+// Function to run A* from src to dest: nodes are expanded in order of
+// distance plus heuristic(node), a lower bound on the distance left. With
+// an admissible heuristic the path is as short as Dijkstra's.
+template <typename G, typename H>
+const vector<int>& astarPath(const G &graph, int src, int dest, const H &heuristic, SearchWorkspace &ws) {
+    SearchLabels &labels = ws.labels[0];
+    IndexedHeap &open = ws.heap[0];
+    labels.reset(graph.size());
+    open.reset(graph.size());
+
+    labels.set(src, 0, -1);
+    open.push(src, heuristic(src));
+    while (!open.empty()) {
+        int u = open.pop();
+        if (u == dest) break;
+
+        int d = labels.dist(u);
+        graph.forEachEdge(u, [&](int v, int weight) {
+            if (d + weight < labels.dist(v)) {
+                labels.set(v, d + weight, u);
+                open.push(v, d + weight + heuristic(v));
+            }
+        });
+    }
+
+    tracePath(labels, dest, ws.path);
+    return ws.path;
+}
+
+template <typename G, typename H>
+vector<int> astarPath(const G &graph, int src, int dest, const H &heuristic) {
+    SearchWorkspace ws;
+    return astarPath(graph, src, dest, heuristic, ws);
+}
+
+// Function to run Dijkstra from both ends at once, always growing the side
+// whose frontier is closer, and stopping once the two frontiers together
+// cannot beat the best meeting found. Edges must be symmetric, as in Graph.
+template <typename G>
+const vector<int>& bidirectionalPath(const G &graph, int src, int dest, SearchWorkspace &ws) {
+    SearchLabels *labels = ws.labels;
+    IndexedHeap *heap = ws.heap;
+    for (int side = 0; side < 2; ++side) {
+        labels[side].reset(graph.size());
+        heap[side].reset(graph.size());
+    }
+
+    labels[0].set(src, 0, -1);
+    labels[1].set(dest, 0, -1);
+    heap[0].push(src, 0);
+    heap[1].push(dest, 0);
+
+    // Best path found so far runs src ~> meetFrom[0] -> meetFrom[1] ~> dest
+    long long best = INF_DIST;
+    int meetFrom[2] = { -1, -1 };
+    if (src == dest) {
+        best = 0;
+        meetFrom[0] = meetFrom[1] = src;
+    }
+
+    while (!heap[0].empty() && !heap[1].empty()) {
+        if (static_cast<long long>(heap[0].topKey()) + heap[1].topKey() >= best) break;
+
+        int side = heap[0].topKey() <= heap[1].topKey() ? 0 : 1;
+        int d = heap[side].topKey();
+        int u = heap[side].pop();
+        SearchLabels &mine = labels[side];
+        const SearchLabels &other = labels[1 - side];
+
+        graph.forEachEdge(u, [&](int v, int weight) {
+            if (d + weight < mine.dist(v)) {
+                mine.set(v, d + weight, u);
+                heap[side].push(v, d + weight);
+            }
+            if (other.reached(v) && static_cast<long long>(d) + weight + other.dist(v) < best) {
+                best = static_cast<long long>(d) + weight + other.dist(v);
+                meetFrom[side] = u;
+                meetFrom[1 - side] = v;
+            }
+        });
+    }
+
+    vector<int> &path = ws.path;
+    if (meetFrom[0] < 0) {
+        tracePath(labels[0], dest, path);
+        return path;
+    }
+
+    tracePath(labels[0], meetFrom[0], path);
+    if (meetFrom[1] != meetFrom[0]) {
+        for (int at = meetFrom[1]; at != -1; at = labels[1].prev(at)) path.push_back(at);
+    }
+    return path;
+}
+
+template <typename G>
+vector<int> bidirectionalPath(const G &graph, int src, int dest) {
+    SearchWorkspace ws;
+    return bidirectionalPath(graph, src, dest, ws);
+}
+
+// Function to run Dijkstra from src until every node in `targets` is
+// settled (or cannot be reached), so queries sharing a source need just one
+// search. Results are in ws.labels[0]; ws.labels[1] marks the targets.
+template <typename G>
+void multiTargetSearch(const G &graph, int src, const vector<int> &targets, SearchWorkspace &ws) {
+    SearchLabels &labels = ws.labels[0];
+    SearchLabels &pending = ws.labels[1];
+    IndexedHeap &heap = ws.heap[0];
+    labels.reset(graph.size());
+    pending.reset(graph.size());
+    heap.reset(graph.size());
+
+    size_t remaining = 0;
+    for (int target : targets) {
+        if (!pending.reached(target)) {
+            pending.set(target, 0, -1);
+            remaining++;
+        }
+    }
+
+    labels.set(src, 0, -1);
+    heap.push(src, 0);
+    while (!heap.empty() && remaining > 0) {
+        int d = heap.topKey();
+        int u = heap.pop();
+        if (pending.reached(u)) remaining--;
+
+        graph.forEachEdge(u, [&](int v, int weight) {
+            if (d + weight < labels.dist(v)) {
+                labels.set(v, d + weight, u);
+                heap.push(v, d + weight);
+            }
+        });
+    }
+}
+
+#endif
@@ -0,0 +1,72 @@
+#include "QueryEngine.h"
+#include <algorithm>
+#include <chrono>
+
+static double elapsedMs(chrono::steady_clock::time_point since) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - since).count();
+}
+
+QueryEngine::QueryEngine(const CsrGraph &graph, unsigned threads, QueuePolicy policy)
+    : graph(graph), policy(policy), pool(threads) {
+    for (unsigned i = 0; i < pool.size(); ++i) workspaces.push_back(unique_ptr<SearchWorkspace>(new SearchWorkspace));
+}
+
+vector<RouteResult> QueryEngine::run(const vector<RouteQuery> &queries, BatchStats *stats) {
+    auto start = chrono::steady_clock::now();
+    vector<RouteResult> results(queries.size());
+
+    // Group query indices by source; each group is one task
+    vector<size_t> order(queries.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    sort(order.begin(), order.end(), [&](size_t a, size_t b) { return queries[a].src < queries[b].src; });
+
+    vector<size_t> groupStart;
+    for (size_t i = 0; i < order.size(); ++i) {
+        if (i == 0 || queries[order[i]].src != queries[order[i - 1]].src) groupStart.push_back(i);
+    }
+    groupStart.push_back(order.size());
+
+    pool.run(groupStart.size() - 1, [&](size_t group, unsigned worker) {
+        auto searchStart = chrono::steady_clock::now();
+        SearchWorkspace &ws = *workspaces[worker];
+        size_t begin = groupStart[group], end = groupStart[group + 1];
+        int src = queries[order[begin]].src;
+
+        if (end - begin == 1) {
+            RouteResult &result = results[order[begin]];
+            int dest = queries[order[begin]].dest;
+            result.path = graph.dijkstra(src, dest, ws, policy);
+            result.distance = ws.labels[0].dist(dest);
+            result.latencyMs = elapsedMs(searchStart);
+            return;
+        }
+
+        vector<int> targets;
+        for (size_t i = begin; i < end; ++i) targets.push_back(queries[order[i]].dest);
+        multiTargetSearch(graph, src, targets, ws);
+
+        for (size_t i = begin; i < end; ++i) {
+            RouteResult &result = results[order[i]];
+            tracePath(ws.labels[0], queries[order[i]].dest, result.path);
+            result.distance = ws.labels[0].dist(queries[order[i]].dest);
+        }
+        double latency = elapsedMs(searchStart);
+        for (size_t i = begin; i < end; ++i) results[order[i]].latencyMs = latency;
+    });
+
+    if (stats != nullptr) {
+        vector<double> latencies;
+        for (const RouteResult &result : results) latencies.push_back(result.latencyMs);
+        sort(latencies.begin(), latencies.end());
+
+        stats->queries = queries.size();
+        stats->searches = groupStart.size() - 1;
+        if (!latencies.empty()) {
+            stats->p50Ms = latencies[(latencies.size() - 1) / 2];
+            stats->p99Ms = latencies[(latencies.size() - 1) * 99 / 100];
+            stats->maxMs = latencies.back();
+        }
+        stats->wallMs = elapsedMs(start);
+    }
+    return results;
+}
@@ -0,0 +1,50 @@
+#ifndef QUERYENGINE_H
+#define QUERYENGINE_H
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include "CsrGraph.h"
+#include "WorkStealingPool.h"
+
+using namespace std;
+
+struct RouteQuery {
+    int src, dest;
+};
+
+// Path in the format Graph::dijkstra returns, its length (INF_DIST if dest
+// cannot be reached) and how long the query took to answer
+struct RouteResult {
+    vector<int> path;
+    int distance = INF_DIST;
+    double latencyMs = 0;
+};
+
+struct BatchStats {
+    size_t queries = 0;
+    size_t searches = 0; // one per distinct source
+    double p50Ms = 0;
+    double p99Ms = 0;
+    double maxMs = 0;
+    double wallMs = 0;
+};
+
+// Answers batches of shortest path queries in parallel against one shared,
+// read-only graph. Queries with the same source are answered by a single
+// search; searches run on a work-stealing pool, each worker with its own
+// workspace. A query's latency is the time of the search that answered it.
+class QueryEngine {
+public:
+    QueryEngine(const CsrGraph &graph, unsigned threads = 0, QueuePolicy policy = QUEUE_AUTO);
+
+    vector<RouteResult> run(const vector<RouteQuery> &queries, BatchStats *stats = nullptr);
+
+private:
+    const CsrGraph &graph;
+    QueuePolicy policy;
+    WorkStealingPool pool;
+    vector<unique_ptr<SearchWorkspace>> workspaces;
+};
+
+#endif
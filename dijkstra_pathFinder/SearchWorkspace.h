@@ -0,0 +1,61 @@
+#ifndef SEARCHWORKSPACE_H
+#define SEARCHWORKSPACE_H
+
+#include <vector>
+#include <utility>
+#include <limits>
+#include <cstdint>
+#include "IndexedHeap.h"
+
+using namespace std;
+
+const int INF_DIST = numeric_limits<int>::max();
+
+// Distance and predecessor per node for one search. Labels carry the epoch
+// they were written in, so reset() invalidates all of them by bumping the
+// epoch instead of refilling n entries.
+class SearchLabels {
+public:
+    void reset(int n) {
+        if (static_cast<int>(stamp.size()) < n) {
+            distance.resize(n);
+            previous.resize(n);
+            stamp.resize(n, 0);
+        }
+        if (++epoch == 0) {
+            // Epoch wrapped: old stamps could look current again
+            fill(stamp.begin(), stamp.end(), 0);
+            epoch = 1;
+        }
+    }
+
+    bool reached(int u) const { return stamp[u] == epoch; }
+    int dist(int u) const { return reached(u) ? distance[u] : INF_DIST; }
+    int prev(int u) const { return reached(u) ? previous[u] : -1; }
+
+    void set(int u, int d, int p) {
+        stamp[u] = epoch;
+        distance[u] = d;
+        previous[u] = p;
+    }
+
+private:
+    vector<int> distance;
+    vector<int> previous;
+    vector<uint32_t> stamp;
+    uint32_t epoch = 0;
+};
+
+// Everything a query needs besides the graph, kept across queries so a
+// search allocates nothing once the buffers have grown to size. Not
+// thread-safe: give each thread its own workspace.
+struct SearchWorkspace {
+    SearchLabels labels[2]; // forward search, and backward for bidirectional
+    IndexedHeap heap[2];
+    vector<pair<int, int>> lazyHeap;
+    vector<vector<int>> buckets;
+    vector<int> queue;
+    vector<int> path;
+};
+
+#endif
@@ -0,0 +1,85 @@
+#include "WorkStealingPool.h"
+#include <algorithm>
+
+WorkStealingPool::WorkStealingPool(unsigned threads) {
+    if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+    for (unsigned i = 0; i < threads; ++i) queues.push_back(unique_ptr<Queue>(new Queue));
+    for (unsigned i = 0; i < threads; ++i) workers.emplace_back(&WorkStealingPool::work, this, i);
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    batchReady.notify_all();
+    for (thread &worker : workers) worker.join();
+}
+
+void WorkStealingPool::run(size_t count, const function<void(size_t, unsigned)> &task) {
+    if (count == 0) return;
+
+    // Hand each worker one contiguous share of the batch
+    unsigned n = workers.size();
+    for (unsigned w = 0; w < n; ++w) {
+        size_t begin = count * w / n, end = count * (w + 1) / n;
+        lock_guard<mutex> guard(queues[w]->lock);
+        for (size_t i = begin; i < end; ++i) queues[w]->tasks.push_back(i);
+    }
+
+    unique_lock<mutex> guard(lock);
+    current = &task;
+    busy = n;
+    batch++;
+    batchReady.notify_all();
+    batchDone.wait(guard, [this] { return busy == 0; });
+    current = nullptr;
+}
+
+// Function to take the next task: our own newest one, else the oldest task
+// of another worker
+bool WorkStealingPool::take(unsigned id, size_t &task) {
+    {
+        Queue &own = *queues[id];
+        lock_guard<mutex> guard(own.lock);
+        if (!own.tasks.empty()) {
+            task = own.tasks.back();
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+
+    unsigned n = queues.size();
+    for (unsigned k = 1; k < n; ++k) {
+        Queue &victim = *queues[(id + k) % n];
+        lock_guard<mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::work(unsigned id) {
+    size_t seen = 0;
+    while (true) {
+        const function<void(size_t, unsigned)> *task;
+        {
+            unique_lock<mutex> guard(lock);
+            batchReady.wait(guard, [&] { return stopping || batch != seen; });
+            if (stopping) return;
+            seen = batch;
+            task = current;
+        }
+
+        // Tasks never create more tasks, so once every deque is empty the
+        // batch only waits for the tasks still running
+        size_t i;
+        while (take(id, i)) (*task)(i, id);
+
+        lock_guard<mutex> guard(lock);
+        if (--busy == 0) batchDone.notify_one();
+    }
+}
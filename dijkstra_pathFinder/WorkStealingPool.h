@@ -0,0 +1,53 @@
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <cstddef>
+
+using namespace std;
+
+// Fixed set of worker threads that run batches of indexed tasks. Each batch
+// is split evenly over per-worker deques; a worker takes tasks from the back
+// of its own deque and, once that is empty, steals from the front of the
+// others, so uneven task costs still keep every core busy.
+class WorkStealingPool {
+public:
+    WorkStealingPool(unsigned threads);
+    ~WorkStealingPool();
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    unsigned size() const { return workers.size(); }
+
+    // Runs task(i, worker) for every i in [0, count) and returns once all
+    // are done; `worker` identifies the thread, for per-thread state
+    void run(size_t count, const function<void(size_t, unsigned)> &task);
+
+private:
+    struct Queue {
+        mutex lock;
+        deque<size_t> tasks;
+    };
+
+    void work(unsigned id);
+    bool take(unsigned id, size_t &task);
+
+    vector<thread> workers;
+    vector<unique_ptr<Queue>> queues;
+    const function<void(size_t, unsigned)> *current = nullptr;
+
+    mutex lock;
+    condition_variable batchReady;
+    condition_variable batchDone;
+    size_t batch = 0;
+    unsigned busy = 0;
+    bool stopping = false;
+};
+
+#endif
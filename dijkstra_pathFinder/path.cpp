@@ -1,75 +1,247 @@
 #include <SFML/Graphics.hpp>
-#include "Graph.h"
+#include "GridGraph.h"
+#include "AsyncSearch.h"
+#include "MapLoader.h"
+#include <iostream>
 #include <vector>
+#include <string>
+#include <cstdlib>
+#include <algorithm>
 
 using namespace std;
 
 const int WINDOW_WIDTH = 800;
 const int WINDOW_HEIGHT = 800;
-const int GRID_SIZE = 20;
-const int CELL_SIZE = WINDOW_WIDTH / GRID_SIZE;
+const int DEFAULT_GRID_SIZE = 20;
+
+const char *SEARCH_NAMES[] = { "Dijkstra", "A*", "Bidirectional" };
+
+// Nodes the search may settle per frame at first; + and - double or halve
+// it, and Space toggles running each search to completion at once
+const int DEFAULT_STEPS_PER_FRAME = 4;
+
+// A wheel notch zooms by ZOOM_STEP, an arrow key pans by PAN_STEP of the view
+const float ZOOM_STEP = 1.2f;
+const float PAN_STEP = 0.1f;
 
 enum CellState {
     EMPTY,
     OBSTACLE,
     START,
     END,
-    PATH
+    PATH,
+    VISITED,  // settled by the search
+    FRONTIER  // queued by the search
 };
 
-void drawGrid(sf::RenderWindow &window, vector<vector<CellState>> &grid, const vector<pair<int, int>> &path) {
-    window.clear(sf::Color::White);
+const sf::Color CELL_COLORS[] = {
+    sf::Color::White,  // EMPTY, shaded darker by terrain weight
+    sf::Color::Black,  // OBSTACLE
+    sf::Color::Green,  // START
+    sf::Color::Red,    // END
+    sf::Color::Yellow, // PATH
+    sf::Color(170, 200, 255), // VISITED
+    sf::Color(120, 220, 140)  // FRONTIER
+};
 
-    // Draw grid lines
-    for (int i = 0; i <= GRID_SIZE; ++i) {
-        sf::Vertex verticalLine[] = {
-            sf::Vertex(sf::Vector2f(i * CELL_SIZE, 0), sf::Color::Black),
-            sf::Vertex(sf::Vector2f(i * CELL_SIZE, WINDOW_HEIGHT), sf::Color::Black)
-        };
-        window.draw(verticalLine, 2, sf::Lines);
-
-        sf::Vertex horizontalLine[] = {
-            sf::Vertex(sf::Vector2f(0, i * CELL_SIZE), sf::Color::Black),
-            sf::Vertex(sf::Vector2f(WINDOW_WIDTH, i * CELL_SIZE), sf::Color::Black)
-        };
-        window.draw(horizontalLine, 2, sf::Lines);
-    }
+// Cell states of the grid and the vertex arrays that show them: one quad per
+// cell, drawn in a single call, and static grid lines. Cell (x, y) owns
+// quad vertices 4 * (y * width + x) onwards.
+struct GridView {
+    int width, height;
+    int cellSize;
+    int cellGap; // one pixel for the grid lines, unless cells are too small for them
+    vector<CellState> states;
+    vector<sf::Color> emptyColors;
+    sf::VertexArray cells;
+    sf::VertexArray lines;
 
-    for (int y = 0; y < GRID_SIZE; ++y) {
-        for (int x = 0; x < GRID_SIZE; ++x) {
-            sf::RectangleShape cell(sf::Vector2f(CELL_SIZE - 1, CELL_SIZE - 1));
-            cell.setPosition(x * CELL_SIZE, y * CELL_SIZE);
-
-            switch (grid[y][x]) {
-                case EMPTY: cell.setFillColor(sf::Color::White); break;
-                case OBSTACLE: cell.setFillColor(sf::Color::Black); break;
-                case START: cell.setFillColor(sf::Color::Green); break;
-                case END: cell.setFillColor(sf::Color::Red); break;
-                case PATH: cell.setFillColor(sf::Color::Blue); break;
-            }
+    CellState state(int x, int y) const { return states[y * width + x]; }
+};
 
-            window.draw(cell);
+sf::Color terrainColor(int weight) {
+    int level = 255 - (min(weight, MAP_MAX_TERRAIN_WEIGHT) - 1) * 135 / (MAP_MAX_TERRAIN_WEIGHT - 1);
+    return sf::Color(level, level, level);
+}
+
+// Function to lay out a width x height grid, with cells as in `terrain`
+// (GridGraph::setTerrain weights)
+void buildView(GridView &view, int width, int height, const vector<int> &terrain) {
+    view.width = width;
+    view.height = height;
+    view.cellSize = max(1, min(WINDOW_WIDTH / width, WINDOW_HEIGHT / height));
+    view.cellGap = view.cellSize > 4 ? 1 : 0;
+    view.states.assign(width * height, EMPTY);
+    view.emptyColors.resize(width * height);
+
+    view.cells = sf::VertexArray(sf::Quads, 4 * width * height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            int u = y * width + x;
+            view.emptyColors[u] = terrainColor(max(terrain[u], 1));
+            view.states[u] = terrain[u] <= 0 ? OBSTACLE : EMPTY;
+            sf::Color color = view.states[u] == OBSTACLE ? CELL_COLORS[OBSTACLE] : view.emptyColors[u];
+
+            sf::Vertex *quad = &view.cells[4 * u];
+            float left = x * view.cellSize, top = y * view.cellSize;
+            float right = left + view.cellSize - view.cellGap, bottom = top + view.cellSize - view.cellGap;
+            quad[0] = sf::Vertex(sf::Vector2f(left, top), color);
+            quad[1] = sf::Vertex(sf::Vector2f(right, top), color);
+            quad[2] = sf::Vertex(sf::Vector2f(right, bottom), color);
+            quad[3] = sf::Vertex(sf::Vector2f(left, bottom), color);
         }
     }
 
-    for (const auto &p : path) {
-        sf::RectangleShape cell(sf::Vector2f(CELL_SIZE - 1, CELL_SIZE - 1));
-        cell.setPosition(p.second * CELL_SIZE, p.first * CELL_SIZE);
-        cell.setFillColor(sf::Color::Yellow);
-        window.draw(cell);
+    // Grid lines never change, so they are built once
+    float gridWidth = width * view.cellSize, gridHeight = height * view.cellSize;
+    view.lines = sf::VertexArray(sf::Lines, 2 * (width + 1) + 2 * (height + 1));
+    size_t k = 0;
+    for (int i = 0; i <= width; ++i) {
+        view.lines[k++] = sf::Vertex(sf::Vector2f(i * view.cellSize, 0), sf::Color::Black);
+        view.lines[k++] = sf::Vertex(sf::Vector2f(i * view.cellSize, gridHeight), sf::Color::Black);
+    }
+    for (int i = 0; i <= height; ++i) {
+        view.lines[k++] = sf::Vertex(sf::Vector2f(0, i * view.cellSize), sf::Color::Black);
+        view.lines[k++] = sf::Vertex(sf::Vector2f(gridWidth, i * view.cellSize), sf::Color::Black);
     }
+}
+
+// Function to change a cell's state, recolouring only its quad
+void setCell(GridView &view, int x, int y, CellState state) {
+    int u = y * view.width + x;
+    if (view.states[u] == state) return;
+    view.states[u] = state;
+    sf::Color color = state == EMPTY ? view.emptyColors[u] : CELL_COLORS[state];
+    sf::Vertex *quad = &view.cells[4 * u];
+    for (int k = 0; k < 4; ++k) quad[k].color = color;
+}
 
+// Function to mark a node with search progress, leaving obstacles and the
+// endpoints as they are
+void setSearchCell(GridView &view, int node, CellState state) {
+    CellState current = view.states[node];
+    if (current == EMPTY || current == VISITED || current == FRONTIER || current == PATH) {
+        setCell(view, node % view.width, node / view.width, state);
+    }
+}
+
+// Function to clear the marks of the previous search
+void clearSearch(GridView &view) {
+    for (int u = 0; u < view.width * view.height; ++u) {
+        CellState current = view.states[u];
+        if (current == VISITED || current == FRONTIER || current == PATH) setCell(view, u % view.width, u / view.width, EMPTY);
+    }
+}
+
+// Function to read a map image into terrain weights: PGM files directly,
+// any other format SFML can load (BMP, PNG, ...) through its luminance
+bool loadMap(const string &fileName, int &width, int &height, vector<int> &terrain) {
+    vector<uint8_t> pixels;
+    if (fileName.size() >= 4 && fileName.compare(fileName.size() - 4, 4, ".pgm") == 0) {
+        if (!loadPgm(fileName, width, height, pixels)) return false;
+    } else {
+        sf::Image image;
+        if (!image.loadFromFile(fileName)) return false;
+        width = image.getSize().x;
+        height = image.getSize().y;
+        pixels.resize(static_cast<size_t>(width) * height);
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                sf::Color c = image.getPixel(x, y);
+                pixels[y * width + x] = static_cast<uint8_t>((299 * c.r + 587 * c.g + 114 * c.b) / 1000);
+            }
+        }
+    }
+    terrain = terrainWeights(pixels);
+    return true;
+}
+
+// Function to frame the whole grid, shrinking it if it is larger than the window
+sf::View fitView(const GridView &view) {
+    float scale = max(1.0f, max(view.width * view.cellSize / float(WINDOW_WIDTH), view.height * view.cellSize / float(WINDOW_HEIGHT)));
+    return sf::View(sf::FloatRect(0, 0, WINDOW_WIDTH * scale, WINDOW_HEIGHT * scale));
+}
+
+string windowTitle(SearchMode mode, int stepsPerFrame, size_t expansions) {
+    string steps = stepsPerFrame > 0 ? to_string(stepsPerFrame) + " steps/frame" : "instant";
+    return string("Shortest Path Visualization - ") + SEARCH_NAMES[mode] + " - " + steps
+        + " - " + to_string(expansions) + " expanded";
+}
+
+void drawGrid(sf::RenderWindow &window, const GridView &view) {
+    window.clear(sf::Color::White);
+    if (view.cellGap > 0) window.draw(view.lines);
+    window.draw(view.cells);
     window.display();
 }
 
-int main() {
+void printUsage(const char *program) {
+    cerr << "Usage: " << program << " [-8] [-s <width> <height>] [map]" << endl;
+    cerr << "  -8  8-connected grid with octile step costs" << endl;
+    cerr << "  -s  size of an empty grid (default " << DEFAULT_GRID_SIZE << " x " << DEFAULT_GRID_SIZE << ")" << endl;
+    cerr << "  map PGM or other image; dark pixels are obstacles, grey ones costlier terrain" << endl;
+}
+
+int main(int argc, char *argv[]) {
+    bool diagonal = false;
+    int width = DEFAULT_GRID_SIZE, height = DEFAULT_GRID_SIZE;
+    string mapFile;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "-8") {
+            diagonal = true;
+        } else if (arg == "-s" && i + 2 < argc) {
+            width = atoi(argv[++i]);
+            height = atoi(argv[++i]);
+        } else if (arg[0] != '-' && mapFile.empty()) {
+            mapFile = arg;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    vector<int> terrain;
+    if (!mapFile.empty()) {
+        if (!loadMap(mapFile, width, height, terrain)) {
+            cerr << "Error loading map: " << mapFile << endl;
+            return 1;
+        }
+    } else if (width <= 0 || height <= 0) {
+        printUsage(argv[0]);
+        return 1;
+    } else {
+        terrain.assign(width * height, 1);
+    }
+
     sf::RenderWindow window(sf::VideoMode(WINDOW_WIDTH, WINDOW_HEIGHT), "Shortest Path Visualization");
-    vector<vector<CellState>> grid(GRID_SIZE, vector<CellState>(GRID_SIZE, EMPTY));
+    window.setFramerateLimit(60);
+
+    GridView view;
+    buildView(view, width, height, terrain);
+    sf::View camera = fitView(view);
+    window.setView(camera);
 
-    Graph graph(GRID_SIZE * GRID_SIZE);
+    GridGraph graph(width, height, diagonal);
+    graph.setTerrain(terrain);
 
     bool startSet = false, endSet = false;
     int startX = -1, startY = -1, endX = -1, endY = -1;
+    bool routeChanged = false;
+    int stepsPerFrame = DEFAULT_STEPS_PER_FRAME;
+    size_t expansions = 0;
+    bool titleChanged = true;
+
+    // Middle-button drag pans the view
+    bool panning = false;
+    sf::Vector2i panFrom;
+
+    // The search runs on a worker; the loop hands it a step budget every
+    // frame and draws whatever progress it has published
+    AsyncSearch search;
+    SearchSnapshot snapshot;
+    vector<int> frontier;
+    bool searching = false;
 
     while (window.isOpen()) {
         sf::Event event;
@@ -77,65 +249,136 @@ int main() {
             if (event.type == sf::Event::Closed)
                 window.close();
 
+            if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Middle) {
+                panning = true;
+                panFrom = sf::Vector2i(event.mouseButton.x, event.mouseButton.y);
+            }
+            if (event.type == sf::Event::MouseButtonReleased && event.mouseButton.button == sf::Mouse::Middle) {
+                panning = false;
+            }
+            if (event.type == sf::Event::MouseMoved && panning) {
+                sf::Vector2i to(event.mouseMove.x, event.mouseMove.y);
+                camera.move(window.mapPixelToCoords(panFrom) - window.mapPixelToCoords(to));
+                window.setView(camera);
+                panFrom = to;
+            }
+
+            // The wheel zooms around the cursor
+            if (event.type == sf::Event::MouseWheelScrolled) {
+                sf::Vector2i pixel(event.mouseWheelScroll.x, event.mouseWheelScroll.y);
+                sf::Vector2f before = window.mapPixelToCoords(pixel);
+                camera.zoom(event.mouseWheelScroll.delta > 0 ? 1 / ZOOM_STEP : ZOOM_STEP);
+                window.setView(camera);
+                camera.move(before - window.mapPixelToCoords(pixel));
+                window.setView(camera);
+            }
+
             if (event.type == sf::Event::MouseButtonPressed) {
-                int x = event.mouseButton.x / CELL_SIZE;
-                int y = event.mouseButton.y / CELL_SIZE;
+                sf::Vector2f point = window.mapPixelToCoords(sf::Vector2i(event.mouseButton.x, event.mouseButton.y));
+                if (point.x < 0 || point.y < 0) continue;
+                int x = static_cast<int>(point.x) / view.cellSize;
+                int y = static_cast<int>(point.y) / view.cellSize;
+                if (x >= width || y >= height) continue;
 
                 if (event.mouseButton.button == sf::Mouse::Left) {
-                    grid[y][x] = OBSTACLE;
-                } else if (event.mouseButton.button == sf::Mouse::Right) {
+                    // Left click toggles an obstacle
+                    if (view.state(x, y) == OBSTACLE) {
+                        setCell(view, x, y, EMPTY);
+                        graph.setBlocked(x, y, false);
+                        routeChanged = true;
+                    } else if (view.state(x, y) != START && view.state(x, y) != END) {
+                        setCell(view, x, y, OBSTACLE);
+                        graph.setBlocked(x, y, true);
+                        routeChanged = true;
+                    }
+                } else if (event.mouseButton.button == sf::Mouse::Right && view.state(x, y) != OBSTACLE) {
                     if (!startSet) {
                         startX = x;
                         startY = y;
-                        grid[y][x] = START;
+                        setCell(view, x, y, START);
                         startSet = true;
                     } else if (!endSet) {
                         endX = x;
                         endY = y;
-                        grid[y][x] = END;
+                        setCell(view, x, y, END);
                         endSet = true;
+                        routeChanged = true;
                     }
                 }
             }
-        }
 
-        if (startSet && endSet) {
-            for (int y = 0; y < GRID_SIZE; ++y) {
-                for (int x = 0; x < GRID_SIZE; ++x) {
-                    if (grid[y][x] == EMPTY) {
-                        int nodeIndex = y * GRID_SIZE + x;
-                        if (y > 0 && grid[y - 1][x] != OBSTACLE) {
-                            graph.addEdge(nodeIndex, (y - 1) * GRID_SIZE + x, 1);
-                        }
-                        if (y < GRID_SIZE - 1 && grid[y + 1][x] != OBSTACLE) {
-                            graph.addEdge(nodeIndex, (y + 1) * GRID_SIZE + x, 1);
-                        }
-                        if (x > 0 && grid[y][x - 1] != OBSTACLE) {
-                            graph.addEdge(nodeIndex, y * GRID_SIZE + (x - 1), 1);
-                        }
-                        if (x < GRID_SIZE - 1 && grid[y][x + 1] != OBSTACLE) {
-                            graph.addEdge(nodeIndex, y * GRID_SIZE + (x + 1), 1);
-                        }
-                    }
-                }
+            if (event.type != sf::Event::KeyPressed) continue;
+            sf::Keyboard::Key key = event.key.code;
+
+            // R resets the grid (or the loaded map) to start over
+            if (key == sf::Keyboard::R) {
+                search.cancel();
+                buildView(view, width, height, terrain);
+                graph.setTerrain(terrain);
+                startSet = endSet = searching = false;
+                frontier.clear();
+            }
+
+            // D, A and B pick Dijkstra, A* or bidirectional search
+            SearchMode mode = graph.searchMode();
+            if (key == sf::Keyboard::D) mode = SEARCH_DIJKSTRA;
+            if (key == sf::Keyboard::A) mode = SEARCH_ASTAR;
+            if (key == sf::Keyboard::B) mode = SEARCH_BIDIRECTIONAL;
+            if (mode != graph.searchMode()) {
+                graph.setSearchMode(mode);
+                routeChanged = true;
             }
 
-            vector<int> shortestPath = graph.dijkstra(startY * GRID_SIZE + startX, endY * GRID_SIZE + endX);
-            vector<pair<int, int>> pathCoordinates;
+            // + and - change the search speed, Space makes it instant
+            if ((key == sf::Keyboard::Equal || key == sf::Keyboard::Add) && stepsPerFrame > 0) stepsPerFrame *= 2;
+            if ((key == sf::Keyboard::Hyphen || key == sf::Keyboard::Subtract) && stepsPerFrame > 1) stepsPerFrame /= 2;
+            if (key == sf::Keyboard::Space) stepsPerFrame = stepsPerFrame > 0 ? 0 : DEFAULT_STEPS_PER_FRAME;
+            titleChanged = true;
+
+            // Arrow keys pan, F fits the whole grid back into the window
+            sf::Vector2f size = camera.getSize();
+            if (key == sf::Keyboard::Left) camera.move(-PAN_STEP * size.x, 0);
+            if (key == sf::Keyboard::Right) camera.move(PAN_STEP * size.x, 0);
+            if (key == sf::Keyboard::Up) camera.move(0, -PAN_STEP * size.y);
+            if (key == sf::Keyboard::Down) camera.move(0, PAN_STEP * size.y);
+            if (key == sf::Keyboard::F) camera = fitView(view);
+            window.setView(camera);
+        }
+
+        // Restart the search only after an edit, not every frame
+        if (startSet && endSet && routeChanged) {
+            clearSearch(view);
+            frontier.clear();
+            search.start(graph, graph.node(startX, startY), graph.node(endX, endY));
+            searching = true;
+            expansions = 0;
+            titleChanged = true;
+            routeChanged = false;
+        }
+
+        if (searching) {
+            search.grant(stepsPerFrame);
+            if (search.poll(snapshot)) {
+                for (int node : frontier) setSearchCell(view, node, EMPTY);
+                for (int node : snapshot.settled) setSearchCell(view, node, VISITED);
+                for (int node : snapshot.frontier) setSearchCell(view, node, FRONTIER);
+                frontier.swap(snapshot.frontier);
 
-            for (int node : shortestPath) {
-                int y = node / GRID_SIZE;
-                int x = node % GRID_SIZE;
-                pathCoordinates.push_back({y, x});
-                if (grid[y][x] != START && grid[y][x] != END) {
-                    grid[y][x] = PATH;
+                if (snapshot.done) {
+                    for (int node : snapshot.path) setSearchCell(view, node, PATH);
+                    searching = false;
                 }
+                expansions = snapshot.expansions;
+                titleChanged = true;
             }
-            drawGrid(window, grid, pathCoordinates);
-            window.display();
-        } else {
-            drawGrid(window, grid, {});
         }
+
+        if (titleChanged) {
+            window.setTitle(windowTitle(graph.searchMode(), stepsPerFrame, expansions));
+            titleChanged = false;
+        }
+
+        drawGrid(window, view);
     }
 
     return 0;
@@ -0,0 +1,335 @@
+// Headless route queries over a saved CsrGraph, for batch workloads and for
+// checking the parallel engines against plain Dijkstra without a window.
+//
+// Build from the dijkstra_pathFinder directory:
+//   g++ -O2 -std=c++11 -pthread routes.cpp Graph.cpp GridGraph.cpp CsrGraph.cpp MapLoader.cpp QueryEngine.cpp WorkStealingPool.cpp ContractionHierarchy.cpp -o routes
+
+#include "GridGraph.h"
+#include "CsrGraph.h"
+#include "MapLoader.h"
+#include "QueryEngine.h"
+#include "ContractionHierarchy.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+
+// Share of cells a generated grid blocks, in percent
+const int GENERATED_BLOCKED_PERCENT = 15;
+
+void printUsage(const char *program) {
+    cerr << "Usage: " << program << " [options] <graph.csr> [queries]   answer queries" << endl;
+    cerr << "       " << program << " [options] -s <src> <graph.csr>   all distances from src by delta-stepping" << endl;
+    cerr << "       " << program << " [-8] -g <width> <height> <graph.csr>   write a random weighted grid" << endl;
+    cerr << "       " << program << " [-8] -m <map.pgm> <graph.csr>   write the grid of an occupancy map" << endl;
+    cerr << "Options:" << endl;
+    cerr << "  -j <threads>  worker threads (default: one per core)" << endl;
+    cerr << "  -p <queue>    dijkstra queue: auto, binary, dary, buckets or bfs (default: auto)" << endl;
+    cerr << "  -x <file.ch>  answer with a contraction hierarchy, loaded from the file or" << endl;
+    cerr << "                built and saved there if it does not exist" << endl;
+    cerr << "  -d <delta>    delta-stepping bucket width, 0 picks one (default: 0)" << endl;
+    cerr << "  -c            check every answer against sequential dijkstra" << endl;
+    cerr << "  -q            print only the statistics" << endl;
+    cerr << "  -8            8-connected grid with octile step costs" << endl;
+    cerr << "Queries are \"<src> <dest>\" node pairs, one per line, read from stdin" << endl;
+    cerr << "when no file is given; each answer is printed as src,dest,distance,nodes." << endl;
+    cerr << "With -s every reachable node is printed as node,distance, and the result" << endl;
+    cerr << "is always verified as a shortest-path tree." << endl;
+}
+
+bool parsePolicy(const string &name, QueuePolicy &policy) {
+    if (name == "auto") policy = QUEUE_AUTO;
+    else if (name == "binary") policy = QUEUE_BINARY_HEAP;
+    else if (name == "dary") policy = QUEUE_DARY_HEAP;
+    else if (name == "buckets") policy = QUEUE_BUCKETS;
+    else if (name == "bfs") policy = QUEUE_BFS;
+    else return false;
+    return true;
+}
+
+// Function to save a grid's graph in CSR form
+bool saveGrid(const GridGraph &grid, const string &fileName) {
+    CsrGraph csr(grid.graph());
+    if (!csr.save(fileName)) return false;
+    cerr << "Wrote " << csr.size() << " nodes and " << csr.edgeCount() << " edges to " << fileName << endl;
+    return true;
+}
+
+// Function to read "<src> <dest>" lines, rejecting nodes outside the graph
+bool readQueries(istream &in, int nodes, vector<RouteQuery> &queries) {
+    string line;
+    for (int lineNumber = 1; getline(in, line); ++lineNumber) {
+        istringstream fields(line);
+        RouteQuery query;
+        if (!(fields >> query.src)) continue; // blank line
+        if (!(fields >> query.dest) || query.src < 0 || query.src >= nodes || query.dest < 0 || query.dest >= nodes) {
+            cerr << "Invalid query on line " << lineNumber << ": " << line << endl;
+            return false;
+        }
+        queries.push_back(query);
+    }
+    return true;
+}
+
+// Function to answer the queries one by one with a contraction hierarchy,
+// loading it from fileName or building it and saving it there
+bool runHierarchy(const CsrGraph &graph, const string &fileName, const vector<RouteQuery> &queries,
+                  vector<RouteResult> &results, BatchStats &stats) {
+    ContractionHierarchy hierarchy;
+    if (ifstream(fileName)) {
+        if (!hierarchy.load(fileName)) return false;
+        if (hierarchy.size() != graph.size()) {
+            cerr << "Hierarchy " << fileName << " has " << hierarchy.size() << " nodes, the graph " << graph.size() << endl;
+            return false;
+        }
+    } else {
+        ChBuildStats build;
+        hierarchy.build(graph, &build);
+        cerr << "Built hierarchy in " << build.seconds << " s: " << build.shortcuts << " shortcuts, "
+             << build.indexBytes << " bytes" << endl;
+        if (!hierarchy.save(fileName)) return false;
+    }
+
+    auto start = chrono::steady_clock::now();
+    SearchWorkspace ws;
+    vector<double> latencies;
+    results.resize(queries.size());
+    for (size_t i = 0; i < queries.size(); ++i) {
+        auto queryStart = chrono::steady_clock::now();
+        RouteResult &result = results[i];
+        result.path = hierarchy.query(queries[i].src, queries[i].dest, ws, &result.distance);
+        result.latencyMs = chrono::duration<double, milli>(chrono::steady_clock::now() - queryStart).count();
+        latencies.push_back(result.latencyMs);
+    }
+
+    sort(latencies.begin(), latencies.end());
+    stats.queries = stats.searches = queries.size();
+    if (!latencies.empty()) {
+        stats.p50Ms = latencies[(latencies.size() - 1) / 2];
+        stats.p99Ms = latencies[(latencies.size() - 1) * 99 / 100];
+        stats.maxMs = latencies.back();
+    }
+    stats.wallMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+// Function to add up the weights along a path, or -1 if two consecutive
+// nodes are not joined by an edge
+long long pathLength(const CsrGraph &graph, const vector<int> &path) {
+    long long length = 0;
+    for (size_t i = 1; i < path.size(); ++i) {
+        int best = -1;
+        graph.forEachEdge(path[i - 1], [&](int v, int weight) {
+            if (v == path[i] && (best < 0 || weight < best)) best = weight;
+        });
+        if (best < 0) return -1;
+        length += best;
+    }
+    return length;
+}
+
+// Function to compare each answer with a sequential dijkstra: the same
+// distance, and when dest is reachable a path of edges from src to dest
+// that is that long
+bool checkAnswers(const CsrGraph &graph, const vector<RouteQuery> &queries, const vector<RouteResult> &results) {
+    SearchWorkspace ws;
+    size_t mismatches = 0;
+    for (size_t i = 0; i < queries.size(); ++i) {
+        const RouteQuery &query = queries[i];
+        const RouteResult &result = results[i];
+        graph.dijkstra(query.src, query.dest, ws, QUEUE_DARY_HEAP);
+        int expected = ws.labels[0].dist(query.dest);
+        bool ok = result.distance == expected && !result.path.empty() && result.path.back() == query.dest
+            && (expected == INF_DIST || (result.path.front() == query.src && pathLength(graph, result.path) == expected));
+        if (!ok && mismatches++ < 10) {
+            cerr << "Mismatch for " << query.src << " -> " << query.dest << ": distance " << result.distance
+                 << ", dijkstra " << expected << endl;
+        }
+    }
+    if (mismatches > 0) cerr << mismatches << " of " << queries.size() << " answers differ from dijkstra" << endl;
+    return mismatches == 0;
+}
+
+// Function to compute every distance from src by delta-stepping, verify it
+// as a shortest-path tree and, with check set, compare it with dijkstra
+bool runDeltaStepping(const CsrGraph &graph, int src, unsigned threads, int delta, bool check, bool quiet) {
+    WorkStealingPool pool(threads);
+    vector<int> dist, prev;
+    auto start = chrono::steady_clock::now();
+    graph.deltaStepping(src, dist, prev, pool, delta);
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    size_t reached = 0;
+    for (int u = 0; u < graph.size(); ++u) {
+        if (dist[u] == INF_DIST) continue;
+        reached++;
+        if (!quiet) cout << u << ',' << dist[u] << '\n';
+    }
+    cout.flush();
+    cerr << reached << " of " << graph.size() << " nodes reached from " << src << " on " << pool.size()
+         << " threads in " << ms << " ms" << endl;
+
+    bool ok = checkShortestPaths(graph, src, dist, prev);
+    if (!ok) cerr << "Delta-stepping result is not a shortest-path tree" << endl;
+    if (check) {
+        // dest -1 is never settled, so dijkstra labels every reachable node
+        SearchWorkspace ws;
+        graph.dijkstra(src, -1, ws, QUEUE_DARY_HEAP);
+        size_t mismatches = 0;
+        for (int u = 0; u < graph.size(); ++u) {
+            if (dist[u] != ws.labels[0].dist(u) && mismatches++ < 10) {
+                cerr << "Mismatch at node " << u << ": distance " << dist[u] << ", dijkstra " << ws.labels[0].dist(u) << endl;
+            }
+        }
+        if (mismatches > 0) cerr << mismatches << " distances differ from dijkstra" << endl;
+        ok = ok && mismatches == 0;
+    }
+    return ok;
+}
+
+int main(int argc, char *argv[]) {
+    unsigned threads = 0;
+    QueuePolicy policy = QUEUE_AUTO;
+    bool check = false, quiet = false, diagonal = false;
+    int width = 0, height = 0;
+    int src = -1, delta = 0;
+    string mapFile, hierarchyFile;
+    bool generate = false;
+    vector<string> files;
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "-j" && i + 1 < argc) {
+            int count = atoi(argv[++i]);
+            if (count < 0) {
+                printUsage(argv[0]);
+                return 1;
+            }
+            threads = count;
+        } else if (arg == "-p" && i + 1 < argc) {
+            if (!parsePolicy(argv[++i], policy)) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "-x" && i + 1 < argc) {
+            hierarchyFile = argv[++i];
+        } else if (arg == "-s" && i + 1 < argc) {
+            src = atoi(argv[++i]);
+            if (src < 0) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "-d" && i + 1 < argc) {
+            delta = atoi(argv[++i]);
+            if (delta < 0) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "-c") {
+            check = true;
+        } else if (arg == "-q") {
+            quiet = true;
+        } else if (arg == "-8") {
+            diagonal = true;
+        } else if (arg == "-g" && i + 2 < argc) {
+            generate = true;
+            width = atoi(argv[++i]);
+            height = atoi(argv[++i]);
+        } else if (arg == "-m" && i + 1 < argc) {
+            mapFile = argv[++i];
+        } else if (arg == "-" || arg[0] != '-') {
+            files.push_back(arg);
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (generate || !mapFile.empty()) {
+        if (files.size() != 1 || (generate && !mapFile.empty()) || (generate && (width <= 0 || height <= 0))) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        vector<int> terrain;
+        if (generate) {
+            // Weights 1 to MAP_MAX_TERRAIN_WEIGHT with some obstacles, from
+            // a fixed seed so a size always gives the same graph
+            mt19937 rng(1);
+            terrain.resize(static_cast<size_t>(width) * height);
+            for (int &weight : terrain) {
+                weight = static_cast<int>(rng() % 100) < GENERATED_BLOCKED_PERCENT ? 0 : 1 + rng() % MAP_MAX_TERRAIN_WEIGHT;
+            }
+        } else {
+            vector<uint8_t> pixels;
+            if (!loadPgm(mapFile, width, height, pixels)) {
+                cerr << "Error loading map: " << mapFile << endl;
+                return 1;
+            }
+            terrain = terrainWeights(pixels);
+        }
+        GridGraph grid(width, height, diagonal);
+        grid.setTerrain(terrain);
+        return saveGrid(grid, files[0]) ? 0 : 1;
+    }
+
+    if (files.empty() || files.size() > 2) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    CsrGraph graph;
+    if (!graph.load(files[0], true)) return 1;
+
+    if (src >= 0) {
+        if (files.size() != 1 || src >= graph.size()) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        return runDeltaStepping(graph, src, threads, delta, check, quiet) ? 0 : 1;
+    }
+
+    vector<RouteQuery> queries;
+    if (files.size() == 1 || files[1] == "-") {
+        if (!readQueries(cin, graph.size(), queries)) return 1;
+    } else {
+        ifstream in(files[1]);
+        if (!in) {
+            cerr << "Error opening file: " << files[1] << endl;
+            return 1;
+        }
+        if (!readQueries(in, graph.size(), queries)) return 1;
+    }
+
+    BatchStats stats;
+    vector<RouteResult> results;
+    if (!hierarchyFile.empty()) {
+        if (!runHierarchy(graph, hierarchyFile, queries, results, stats)) return 1;
+    } else {
+        QueryEngine engine(graph, threads, policy);
+        results = engine.run(queries, &stats);
+    }
+
+    if (!quiet) {
+        for (size_t i = 0; i < queries.size(); ++i) {
+            const RouteResult &result = results[i];
+            cout << queries[i].src << ',' << queries[i].dest << ',';
+            if (result.distance != INF_DIST) cout << result.distance << ',' << result.path.size();
+            else cout << ',';
+            cout << '\n';
+        }
+        cout.flush();
+    }
+    cerr << stats.queries << " queries, " << stats.searches << " searches" << endl;
+    cerr << "latency ms: p50 " << stats.p50Ms << ", p99 " << stats.p99Ms << ", max " << stats.maxMs
+         << "; batch " << stats.wallMs << " ms" << endl;
+
+    if (check && !checkAnswers(graph, queries, results)) return 1;
+    return 0;
+}
@@ -0,0 +1,288 @@
+#include "Ans.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+const size_t BITMAP_SIZE = ALPHABET_SIZE / 8;
+
+// Decode table entry: the symbol for a state, and how the next state is
+// formed from newState plus nbBits bits read from the stream
+struct AnsDecodeEntry {
+    uint16_t newState;
+    uint8_t symbol;
+    uint8_t nbBits;
+};
+
+// Per-symbol encoding parameters, as in FSE: (state + deltaNbBits) >> 16 is
+// the number of bits to emit, and deltaFindState locates the next state
+struct AnsSymbolTransform {
+    int32_t deltaFindState;
+    uint32_t deltaNbBits;
+};
+
+static int highBit(uint32_t value) {
+    int bit = 0;
+    while (value >>= 1) bit++;
+    return bit;
+}
+
+static uint64_t load64(const uint8_t* in) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; --i) value = (value << 8) | in[i];
+    return value;
+}
+
+// Function to scale a histogram so the counts sum to ANS_TABLE_SIZE, keeping
+// every present symbol at a count of at least one
+void normalizeCounts(const uint64_t freq[ALPHABET_SIZE], uint16_t norm[ALPHABET_SIZE]) {
+    uint64_t total = 0;
+    for (int i = 0; i < ALPHABET_SIZE; ++i) total += freq[i];
+
+    int sum = 0;
+    for (int i = 0; i < ALPHABET_SIZE; ++i) {
+        norm[i] = 0;
+        if (freq[i] == 0) continue;
+        uint64_t scaled = (freq[i] * ANS_TABLE_SIZE + total / 2) / total;
+        norm[i] = static_cast<uint16_t>(max<uint64_t>(scaled, 1));
+        sum += norm[i];
+    }
+    if (sum == 0) return;
+
+    // Rounding can miss the target; settle the difference on the largest counts
+    while (sum != ANS_TABLE_SIZE) {
+        int largest = 0;
+        for (int i = 1; i < ALPHABET_SIZE; ++i) {
+            if (norm[i] > norm[largest]) largest = i;
+        }
+        if (sum > ANS_TABLE_SIZE) {
+            norm[largest]--;
+            sum--;
+        } else {
+            norm[largest]++;
+            sum++;
+        }
+    }
+}
+
+// Function to spread symbols over the state table so each symbol's states
+// are scattered evenly; the step is odd, so every slot is visited once
+static void spreadSymbols(const uint16_t norm[ALPHABET_SIZE], uint8_t symbols[ANS_TABLE_SIZE]) {
+    const uint32_t step = (ANS_TABLE_SIZE >> 1) + (ANS_TABLE_SIZE >> 3) + 3;
+    uint32_t pos = 0;
+
+    for (int s = 0; s < ALPHABET_SIZE; ++s) {
+        for (int k = 0; k < norm[s]; ++k) {
+            symbols[pos] = static_cast<uint8_t>(s);
+            pos = (pos + step) & (ANS_TABLE_SIZE - 1);
+        }
+    }
+}
+
+// Bit writer that appends values LSB-first; the decoder reads them back in
+// reverse order, starting from the end of the stream
+struct ForwardBitWriter {
+    uint8_t* out;
+    size_t used = 0;
+    uint64_t acc = 0;
+    int bits = 0;
+
+    ForwardBitWriter(uint8_t* o) : out(o) {}
+
+    void put(uint32_t value, int n) {
+        acc |= static_cast<uint64_t>(value) << bits;
+        bits += n;
+        if (bits >= 32) {
+            for (int i = 0; i < 4; ++i) out[used++] = static_cast<uint8_t>(acc >> (8 * i));
+            acc >>= 32;
+            bits -= 32;
+        }
+    }
+
+    void finish() {
+        for (; bits > 0; bits -= 8) {
+            out[used++] = static_cast<uint8_t>(acc);
+            acc >>= 8;
+        }
+    }
+};
+
+// Bit reader that consumes a ForwardBitWriter stream from its end, keeping
+// a 64-bit little-endian window that slides towards the start
+struct BackwardBitReader {
+    uint8_t pad[8];
+    const uint8_t* start;
+    size_t ptr;
+    uint64_t window;
+    unsigned consumed;
+    int paddingBits;
+
+    // Returns false if the stream has no end marker
+    bool init(const uint8_t* in, size_t size) {
+        if (size == 0 || in[size - 1] == 0) return false;
+
+        if (size < 8) {
+            // Short streams are padded at the front with zero bytes
+            memset(pad, 0, sizeof(pad));
+            memcpy(pad + 8 - size, in, size);
+            start = pad;
+            ptr = 0;
+            paddingBits = static_cast<int>(8 - size) * 8;
+        } else {
+            start = in;
+            ptr = size - 8;
+            paddingBits = 0;
+        }
+
+        window = load64(start + ptr);
+        consumed = 8 - highBit(start[ptr + 7]);
+        return true;
+    }
+
+    uint32_t read(int n) {
+        // The double shift keeps n == 0 well defined
+        uint32_t value = static_cast<uint32_t>(((window << (consumed & 63)) >> 1) >> (63 - n));
+        consumed += n;
+        return value;
+    }
+
+    void reload() {
+        size_t bytes = consumed >> 3;
+        if (bytes <= ptr) {
+            ptr -= bytes;
+            consumed &= 7;
+        } else {
+            consumed -= ptr * 8;
+            ptr = 0;
+        }
+        window = load64(start + ptr);
+    }
+
+    // True when every bit has been read exactly once
+    bool exhausted() const {
+        return static_cast<int64_t>(ptr * 8) + 64 - consumed == paddingBits;
+    }
+};
+
+size_t AnsCoder::estimateSize(const uint64_t freq[ALPHABET_SIZE], size_t) const {
+    uint16_t norm[ALPHABET_SIZE];
+    normalizeCounts(freq, norm);
+
+    double bits = 0;
+    size_t header = BITMAP_SIZE + 1;
+    for (int i = 0; i < ALPHABET_SIZE; ++i) {
+        if (norm[i] == 0) continue;
+        bits += freq[i] * (ANS_TABLE_LOG - log2(static_cast<double>(norm[i])));
+        header += norm[i] < 128 ? 1 : 2;
+    }
+    return static_cast<size_t>(bits / 8) + header;
+}
+
+void AnsCoder::encode(const uint8_t* in, size_t size, const uint64_t freq[ALPHABET_SIZE], vector<uint8_t>& out) const {
+    uint16_t norm[ALPHABET_SIZE];
+    normalizeCounts(freq, norm);
+
+    // Header: which symbols are present, then their counts as varints
+    size_t bitmap = out.size();
+    out.resize(bitmap + BITMAP_SIZE, 0);
+    for (int i = 0; i < ALPHABET_SIZE; ++i) {
+        if (norm[i] == 0) continue;
+        out[bitmap + i / 8] |= static_cast<uint8_t>(1 << (i % 8));
+        if (norm[i] < 128) {
+            out.push_back(static_cast<uint8_t>(norm[i]));
+        } else {
+            out.push_back(static_cast<uint8_t>(0x80 | (norm[i] & 0x7F)));
+            out.push_back(static_cast<uint8_t>(norm[i] >> 7));
+        }
+    }
+
+    uint8_t symbols[ANS_TABLE_SIZE];
+    spreadSymbols(norm, symbols);
+
+    // State table: for each symbol, its states in spread order
+    uint16_t cumul[ALPHABET_SIZE + 1];
+    cumul[0] = 0;
+    for (int s = 0; s < ALPHABET_SIZE; ++s) cumul[s + 1] = cumul[s] + norm[s];
+
+    uint16_t stateTable[ANS_TABLE_SIZE];
+    uint16_t next[ALPHABET_SIZE];
+    copy(cumul, cumul + ALPHABET_SIZE, next);
+    for (int u = 0; u < ANS_TABLE_SIZE; ++u) {
+        stateTable[next[symbols[u]]++] = static_cast<uint16_t>(ANS_TABLE_SIZE + u);
+    }
+
+    AnsSymbolTransform transform[ALPHABET_SIZE] = {};
+    for (int s = 0; s < ALPHABET_SIZE; ++s) {
+        if (norm[s] == 0) continue;
+        uint32_t maxBitsOut = norm[s] > 1 ? ANS_TABLE_LOG - highBit(norm[s] - 1) : ANS_TABLE_LOG;
+        uint32_t minStatePlus = static_cast<uint32_t>(norm[s]) << maxBitsOut;
+        transform[s].deltaNbBits = (maxBitsOut << 16) - minStatePlus;
+        transform[s].deltaFindState = cumul[s] - norm[s];
+    }
+
+    // Worst case is ANS_TABLE_LOG bits per byte plus the final state
+    size_t start = out.size();
+    out.resize(start + (size * ANS_TABLE_LOG + 7) / 8 + 16);
+    ForwardBitWriter writer(out.data() + start);
+
+    // Symbols are coded last to first so the decoder emits them in order
+    uint32_t state = ANS_TABLE_SIZE;
+    for (size_t i = size; i-- > 0;) {
+        const AnsSymbolTransform& t = transform[in[i]];
+        uint32_t nbBits = (state + t.deltaNbBits) >> 16;
+        writer.put(state & ((1u << nbBits) - 1), nbBits);
+        state = stateTable[(state >> nbBits) + t.deltaFindState];
+    }
+
+    writer.put(state - ANS_TABLE_SIZE, ANS_TABLE_LOG);
+    writer.put(1, 1); // end marker
+    writer.finish();
+
+    out.resize(start + writer.used);
+}
+
+bool AnsCoder::decode(const uint8_t* in, size_t size, uint8_t* out, size_t originalSize) const {
+    if (size < BITMAP_SIZE) return false;
+
+    uint16_t norm[ALPHABET_SIZE] = {};
+    size_t pos = BITMAP_SIZE;
+    int sum = 0;
+    for (int i = 0; i < ALPHABET_SIZE; ++i) {
+        if (!(in[i / 8] & (1 << (i % 8)))) continue;
+        if (pos >= size) return false;
+        norm[i] = in[pos] & 0x7F;
+        if (in[pos++] & 0x80) {
+            if (pos >= size) return false;
+            norm[i] |= static_cast<uint16_t>(in[pos++]) << 7;
+        }
+        if (norm[i] == 0) return false;
+        sum += norm[i];
+    }
+    if (sum != ANS_TABLE_SIZE) return false;
+
+    uint8_t symbols[ANS_TABLE_SIZE];
+    spreadSymbols(norm, symbols);
+
+    AnsDecodeEntry table[ANS_TABLE_SIZE];
+    uint16_t next[ALPHABET_SIZE];
+    copy(norm, norm + ALPHABET_SIZE, next);
+    for (int u = 0; u < ANS_TABLE_SIZE; ++u) {
+        uint8_t s = symbols[u];
+        uint32_t x = next[s]++;
+        int nbBits = ANS_TABLE_LOG - highBit(x);
+        table[u] = { static_cast<uint16_t>((x << nbBits) - ANS_TABLE_SIZE), s, static_cast<uint8_t>(nbBits) };
+    }
+
+    BackwardBitReader reader;
+    if (!reader.init(in + pos, size - pos)) return false;
+
+    uint32_t state = reader.read(ANS_TABLE_LOG);
+    for (size_t i = 0; i < originalSize; ++i) {
+        reader.reload();
+        const AnsDecodeEntry& entry = table[state];
+        out[i] = entry.symbol;
+        state = entry.newState + reader.read(entry.nbBits);
+    }
+    reader.reload();
+
+    return reader.exhausted();
+}
@@ -0,0 +1,27 @@
+#ifndef ANS_H
+#define ANS_H
+
+#include "EntropyCoder.h"
+
+// Number of states is 2^ANS_TABLE_LOG; symbol probabilities are quantised
+// to multiples of 1 / 2^ANS_TABLE_LOG
+const int ANS_TABLE_LOG = 11;
+const int ANS_TABLE_SIZE = 1 << ANS_TABLE_LOG;
+
+// Table-based asymmetric numeral system coder (tANS, as in FSE). Codes a
+// chunk in fractional bits per symbol, which beats Huffman on skewed data;
+// decoding is one table lookup and one bit read per symbol.
+//
+// Payload: presence bitmap (32 bytes) | varint count per present symbol |
+//          coded bits, written backwards and ending in a 1 marker bit
+class AnsCoder : public EntropyCoder {
+public:
+    CoderMethod method() const override { return METHOD_ANS; }
+    size_t estimateSize(const uint64_t freq[ALPHABET_SIZE], size_t size) const override;
+    void encode(const uint8_t* in, size_t size, const uint64_t freq[ALPHABET_SIZE], vector<uint8_t>& out) const override;
+    bool decode(const uint8_t* in, size_t size, uint8_t* out, size_t originalSize) const override;
+};
+
+void normalizeCounts(const uint64_t freq[ALPHABET_SIZE], uint16_t norm[ALPHABET_SIZE]);
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef BITSTREAM_H
+#define BITSTREAM_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+// Bit writer that packs codes MSB-first through a 64-bit accumulator
+// straight into a pre-sized output buffer. Each put takes at most 32 bits.
+struct BitWriter {
+    uint8_t* out;
+    size_t used = 0;
+    uint64_t acc = 0;
+    int bits = 0;
+
+    BitWriter(uint8_t* o) : out(o) {}
+
+    void put(uint32_t code, int len) {
+        acc = (acc << len) | code;
+        bits += len;
+        if (bits >= 32) {
+            bits -= 32;
+            uint32_t word = static_cast<uint32_t>(acc >> bits);
+            out[used++] = static_cast<uint8_t>(word >> 24);
+            out[used++] = static_cast<uint8_t>(word >> 16);
+            out[used++] = static_cast<uint8_t>(word >> 8);
+            out[used++] = static_cast<uint8_t>(word);
+        }
+    }
+
+    // Pads the last partial byte with zero bits
+    void finish() {
+        while (bits > 0) {
+            int shift = bits - 8;
+            out[used++] = static_cast<uint8_t>(shift >= 0 ? acc >> shift : acc << -shift);
+            bits = max(shift, 0);
+        }
+    }
+};
+
+// Bit reader that keeps the next unread bits left-aligned in a 64-bit
+// buffer; after refill() at least 56 bits can be peeked. Reading past the
+// end of the input yields zero bits.
+struct BitReader {
+    const uint8_t* pos;
+    const uint8_t* end;
+    uint64_t acc = 0;
+    int bits = 0;
+
+    BitReader(const uint8_t* in, size_t size) : pos(in), end(in + size) {}
+
+    void refill() {
+        if (end - pos >= 8) {
+            // Branch-free refill: load eight bytes and keep the whole ones
+            uint64_t word = 0;
+            for (int i = 0; i < 8; ++i) word = (word << 8) | pos[i];
+            acc |= word >> bits;
+            pos += (63 - bits) >> 3;
+            bits |= 56;
+            return;
+        }
+        while (bits <= 56) {
+            uint64_t byte = pos < end ? *pos++ : 0;
+            acc |= byte << (56 - bits);
+            bits += 8;
+        }
+    }
+
+    // n must be between 1 and 32
+    uint32_t peek(int n) const { return static_cast<uint32_t>(acc >> (64 - n)); }
+
+    void consume(int n) {
+        acc <<= n;
+        bits -= n;
+    }
+
+    // Reads n bits, where n may be 0
+    uint32_t read(int n) {
+        if (n == 0) return 0;
+        uint32_t value = peek(n);
+        consume(n);
+        return value;
+    }
+};
+
+#endif
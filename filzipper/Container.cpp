@@ -0,0 +1,498 @@
+#include "Container.h"
+#include "Huffman.h"
+#include "Ans.h"
+#include "Lz77.h"
+#include "FileIO.h"
+#include "ThreadPool.h"
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <cstring>
+
+const char MAGIC[4] = { 'H', 'U', 'F', '3' };
+const char INDEX_MAGIC[4] = { 'H', 'I', 'D', 'X' };
+
+const uint8_t FLAG_SHARED_TABLE = 1;
+
+const size_t HEADER_SIZE = 9;
+const size_t CHUNK_HEADER_SIZE = 9;
+const size_t INDEX_ENTRY_SIZE = 16;
+const size_t TRAILER_SIZE = 28;
+
+struct IndexEntry {
+    uint64_t offset;
+    uint32_t rawSize;
+    uint32_t payloadSize;
+};
+
+// A chunk record read from the input: method and payload view
+struct ChunkView {
+    uint8_t method;
+    const uint8_t* payload;
+    uint32_t payloadSize;
+    uint32_t rawSize;
+};
+
+static void put32(vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+static void put64(vector<uint8_t>& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+static uint32_t get32(const uint8_t* in) {
+    uint32_t value = 0;
+    for (int i = 3; i >= 0; --i) value = (value << 8) | in[i];
+    return value;
+}
+
+static uint64_t get64(const uint8_t* in) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; --i) value = (value << 8) | in[i];
+    return value;
+}
+
+// Function to compress one chunk into a complete chunk record with the
+// coder expected to give the smallest payload, storing the chunk raw if
+// coding it would not make it smaller. With an LZ77 coder, its output is
+// kept when it beats the best order-0 estimate.
+static void compressChunk(const uint8_t* raw, size_t rawSize, const vector<const EntropyCoder*>& coders,
+                          const Lz77Coder* lz, vector<uint8_t>& record) {
+    uint64_t freq[ALPHABET_SIZE] = {};
+    addToHistogram(raw, rawSize, freq);
+
+    const EntropyCoder* best = coders[0];
+    size_t bestSize = best->estimateSize(freq, rawSize);
+    for (size_t i = 1; i < coders.size(); ++i) {
+        size_t estimate = coders[i]->estimateSize(freq, rawSize);
+        if (estimate < bestSize) {
+            best = coders[i];
+            bestSize = estimate;
+        }
+    }
+
+    record.clear();
+    put32(record, rawSize);
+    put32(record, 0); // payload size, patched below
+    record.push_back(METHOD_LZ77);
+
+    bool coded = false;
+    if (lz != nullptr) {
+        lz->encode(raw, rawSize, record);
+        coded = record.size() - CHUNK_HEADER_SIZE < bestSize;
+    }
+    if (!coded) {
+        record.resize(CHUNK_HEADER_SIZE);
+        record[8] = best->method();
+        best->encode(raw, rawSize, freq, record);
+    }
+
+    if (record.size() - CHUNK_HEADER_SIZE >= rawSize) {
+        record.resize(CHUNK_HEADER_SIZE);
+        record[8] = METHOD_STORED;
+        record.insert(record.end(), raw, raw + rawSize);
+    }
+
+    uint32_t payloadSize = record.size() - CHUNK_HEADER_SIZE;
+    for (int i = 0; i < 4; ++i) record[4 + i] = static_cast<uint8_t>(payloadSize >> (8 * i));
+}
+
+// Decoders for every chunk method of one file
+struct Decoders {
+    HuffmanCoder huffman;
+    AnsCoder ans;
+    Lz77Coder lz;
+
+    const EntropyCoder* find(uint8_t method) const {
+        if (method == METHOD_HUFFMAN) return &huffman;
+        if (method == METHOD_ANS) return &ans;
+        return nullptr;
+    }
+};
+
+// Function to decode one chunk payload into `out`, which holds rawSize bytes
+static bool decompressChunk(const ChunkView& chunk, const Decoders& decoders, uint8_t* out) {
+    if (chunk.method == METHOD_STORED) {
+        if (chunk.payloadSize != chunk.rawSize) return false;
+        memcpy(out, chunk.payload, chunk.rawSize);
+        return true;
+    }
+    if (chunk.method == METHOD_LZ77) {
+        return decoders.lz.decode(chunk.payload, chunk.payloadSize, out, chunk.rawSize);
+    }
+
+    const EntropyCoder* coder = decoders.find(chunk.method);
+    if (coder == nullptr) return false;
+    return coder->decode(chunk.payload, chunk.payloadSize, out, chunk.rawSize);
+}
+
+// Function to compress a file into the chunked container, coding chunks in
+// parallel. Chunks are processed in waves of a few per thread so memory use
+// stays bounded however big the input is; mapped inputs are coded in place.
+bool compressFile(const string& inputName, const string& outputName, const CompressOptions& options) {
+    if (options.blockSize == 0 || options.blockSize > MAX_BLOCK_SIZE) {
+        cerr << "Invalid block size: " << options.blockSize << endl;
+        return false;
+    }
+
+    InputFile inFile;
+    if (!inFile.open(inputName)) {
+        cerr << "Error opening file: " << inputName << endl;
+        return false;
+    }
+
+    // A shared table needs one extra pass to build the whole-file histogram
+    uint8_t sharedLengths[ALPHABET_SIZE];
+    if (options.sharedTable) {
+        if (!inFile.seekable()) {
+            cerr << "A shared table needs a seekable input: " << inputName << endl;
+            return false;
+        }
+        uint64_t freq[ALPHABET_SIZE] = {};
+        vector<uint8_t> scratch;
+        const uint8_t* data;
+        while (size_t got = inFile.next(options.blockSize, data, scratch)) {
+            addToHistogram(data, got, freq);
+        }
+        buildCodeLengths(freq, sharedLengths);
+        if (inFile.failed() || !inFile.rewind()) {
+            cerr << "Error reading file: " << inputName << endl;
+            return false;
+        }
+    }
+
+    OutputFile outFile;
+    if (!outFile.open(outputName)) {
+        cerr << "Error opening file: " << outputName << endl;
+        return false;
+    }
+
+    vector<uint8_t> header(MAGIC, MAGIC + sizeof(MAGIC));
+    header.push_back(options.sharedTable ? FLAG_SHARED_TABLE : 0);
+    put32(header, options.blockSize);
+    if (options.sharedTable) {
+        uint8_t packed[PACKED_LENGTHS_SIZE];
+        packLengths(sharedLengths, packed);
+        header.insert(header.end(), packed, packed + PACKED_LENGTHS_SIZE);
+    }
+    outFile.write(header.data(), header.size());
+
+    HuffmanCoder huffman;
+    AnsCoder ans;
+    if (options.sharedTable) huffman.setSharedLengths(sharedLengths);
+
+    vector<const EntropyCoder*> coders;
+    if (options.coder != CODER_ANS) coders.push_back(&huffman);
+    if (options.coder != CODER_HUFFMAN) coders.push_back(&ans);
+
+    Lz77Coder lz(options.level);
+    const Lz77Coder* matcher = options.level > 0 ? &lz : nullptr;
+
+    ThreadPool pool(options.threads);
+    size_t waveSize = pool.size() * 2;
+    vector<vector<uint8_t>> scratch(waveSize), records(waveSize);
+    vector<const uint8_t*> raw(waveSize);
+    vector<size_t> rawSizes(waveSize);
+    vector<IndexEntry> index;
+    uint64_t offset = header.size();
+    uint64_t originalSize = 0;
+    bool done = false;
+
+    while (!done) {
+        size_t count = 0;
+        while (count < waveSize) {
+            rawSizes[count] = inFile.next(options.blockSize, raw[count], scratch[count]);
+            if (rawSizes[count] == 0) {
+                done = true;
+                break;
+            }
+            count++;
+        }
+        if (inFile.failed()) {
+            cerr << "Error reading file: " << inputName << endl;
+            return false;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            pool.submit([&, i] {
+                compressChunk(raw[i], rawSizes[i], coders, matcher, records[i]);
+            });
+        }
+        pool.wait();
+
+        for (size_t i = 0; i < count; ++i) {
+            index.push_back({ offset, static_cast<uint32_t>(rawSizes[i]),
+                              static_cast<uint32_t>(records[i].size() - CHUNK_HEADER_SIZE) });
+            outFile.write(records[i].data(), records[i].size());
+            offset += records[i].size();
+            originalSize += rawSizes[i];
+        }
+    }
+
+    vector<uint8_t> tail(CHUNK_HEADER_SIZE, 0);
+    uint64_t indexOffset = offset + tail.size();
+    for (const auto &entry : index) {
+        put64(tail, entry.offset);
+        put32(tail, entry.rawSize);
+        put32(tail, entry.payloadSize);
+    }
+    put64(tail, index.size());
+    put64(tail, indexOffset);
+    put64(tail, originalSize);
+    tail.insert(tail.end(), INDEX_MAGIC, INDEX_MAGIC + sizeof(INDEX_MAGIC));
+    outFile.write(tail.data(), tail.size());
+
+    if (!outFile.close()) {
+        cerr << "Error writing file: " << outputName << endl;
+        return false;
+    }
+    return true;
+}
+
+// Function to read the file header, setting up the shared Huffman table if
+// the file has one
+static bool readHeader(InputFile& inFile, uint32_t& blockSize, Decoders& decoders) {
+    vector<uint8_t> scratch;
+    const uint8_t* header;
+    if (inFile.next(HEADER_SIZE, header, scratch) != HEADER_SIZE) return false;
+    if (memcmp(header, MAGIC, sizeof(MAGIC)) != 0) return false;
+
+    bool shared = (header[4] & FLAG_SHARED_TABLE) != 0;
+    blockSize = get32(header + 5);
+    if (blockSize == 0 || blockSize > MAX_BLOCK_SIZE) return false;
+    if (!shared) return true;
+
+    const uint8_t* packed;
+    uint8_t lengths[ALPHABET_SIZE];
+    if (inFile.next(PACKED_LENGTHS_SIZE, packed, scratch) != PACKED_LENGTHS_SIZE) return false;
+    unpackLengths(packed, lengths);
+    return decoders.huffman.setSharedLengths(lengths);
+}
+
+// Result of reading the next chunk record sequentially
+enum ChunkStatus {
+    CHUNK_OK,
+    CHUNK_END,
+    CHUNK_BAD
+};
+
+// Function to read the next chunk record, pointing the view at its payload
+static ChunkStatus readChunk(InputFile& inFile, uint32_t blockSize, ChunkView& chunk, vector<uint8_t>& scratch) {
+    const uint8_t* chunkHeader;
+    if (inFile.next(CHUNK_HEADER_SIZE, chunkHeader, scratch) != CHUNK_HEADER_SIZE) return CHUNK_BAD;
+
+    chunk.rawSize = get32(chunkHeader);
+    chunk.payloadSize = get32(chunkHeader + 4);
+    chunk.method = chunkHeader[8];
+    if (chunk.rawSize == 0) return CHUNK_END;
+    if (chunk.rawSize > blockSize || chunk.payloadSize > 2 * blockSize + PACKED_LENGTHS_SIZE) return CHUNK_BAD;
+
+    if (inFile.next(chunk.payloadSize, chunk.payload, scratch) != chunk.payloadSize) return CHUNK_BAD;
+    return CHUNK_OK;
+}
+
+// Function to read the trailer at the end of the file
+static bool readTrailer(InputFile& inFile, uint64_t& count, uint64_t& indexOffset, uint64_t& originalSize) {
+    if (inFile.size() < HEADER_SIZE + TRAILER_SIZE) return false;
+
+    vector<uint8_t> scratch;
+    const uint8_t* trailer;
+    if (!inFile.readAt(inFile.size() - TRAILER_SIZE, TRAILER_SIZE, trailer, scratch)) return false;
+    if (memcmp(trailer + 24, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0) return false;
+
+    count = get64(trailer);
+    indexOffset = get64(trailer + 8);
+    originalSize = get64(trailer + 16);
+    return indexOffset <= inFile.size() && count <= (inFile.size() - indexOffset) / INDEX_ENTRY_SIZE;
+}
+
+// Function to decompress a mapped input straight into a pre-sized, mapped
+// output: workers decode every chunk in place, with no copies in between
+static bool decompressMapped(InputFile& inFile, OutputFile& outFile, uint64_t originalSize, uint32_t blockSize,
+                             const Decoders& decoders, unsigned threads) {
+    ThreadPool pool(threads);
+    atomic<bool> failed(false);
+    vector<uint8_t> scratch;
+    uint64_t rawOffset = 0;
+
+    while (true) {
+        ChunkView chunk;
+        ChunkStatus status = readChunk(inFile, blockSize, chunk, scratch);
+        if (status == CHUNK_END) break;
+        if (status == CHUNK_BAD || chunk.rawSize > originalSize - rawOffset) {
+            failed = true;
+            break;
+        }
+
+        uint8_t* out = outFile.data() + rawOffset;
+        pool.submit([&failed, &decoders, chunk, out] {
+            if (!decompressChunk(chunk, decoders, out)) failed = true;
+        });
+        rawOffset += chunk.rawSize;
+    }
+    pool.wait();
+
+    return !failed && rawOffset == originalSize;
+}
+
+// Function to decompress chunks front to back from any input, decoding each
+// wave of chunks in parallel and writing them out in order
+static bool decompressStream(InputFile& inFile, OutputFile& outFile, uint32_t blockSize,
+                             const Decoders& decoders, unsigned threads) {
+    ThreadPool pool(threads);
+    size_t waveSize = pool.size() * 2;
+    vector<vector<uint8_t>> scratch(waveSize), raw(waveSize);
+    vector<ChunkView> chunks(waveSize);
+    vector<char> ok(waveSize);
+    bool finished = false;
+
+    while (!finished) {
+        size_t count = 0;
+        while (count < waveSize) {
+            ChunkStatus status = readChunk(inFile, blockSize, chunks[count], scratch[count]);
+            if (status == CHUNK_BAD) return false;
+            if (status == CHUNK_END) {
+                finished = true;
+                break;
+            }
+            raw[count].resize(chunks[count].rawSize);
+            count++;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            pool.submit([&, i] {
+                ok[i] = decompressChunk(chunks[i], decoders, raw[i].data());
+            });
+        }
+        pool.wait();
+
+        for (size_t i = 0; i < count; ++i) {
+            if (!ok[i]) return false;
+            outFile.write(raw[i].data(), raw[i].size());
+        }
+    }
+
+    return true;
+}
+
+// Function to decompress a file. Mapped inputs with a known decoded size go
+// straight into a mapped output; pipes and stdout are streamed.
+bool decompressFile(const string& inputName, const string& outputName, unsigned threads) {
+    InputFile inFile;
+    if (!inFile.open(inputName)) {
+        cerr << "Error opening file: " << inputName << endl;
+        return false;
+    }
+
+    uint32_t blockSize;
+    Decoders decoders;
+    if (!readHeader(inFile, blockSize, decoders)) {
+        cerr << "Not a compressed file: " << inputName << endl;
+        return false;
+    }
+
+    uint64_t count, indexOffset, originalSize = 0;
+    bool sized = inFile.mapped() && readTrailer(inFile, count, indexOffset, originalSize);
+
+    OutputFile outFile;
+    bool opened = sized ? outFile.openMapped(outputName, originalSize) : outFile.open(outputName);
+    if (!opened) {
+        cerr << "Error opening file: " << outputName << endl;
+        return false;
+    }
+
+    bool ok = outFile.mapped()
+        ? decompressMapped(inFile, outFile, originalSize, blockSize, decoders, threads)
+        : decompressStream(inFile, outFile, blockSize, decoders, threads);
+    if (!ok) {
+        cerr << "Corrupt data: " << inputName << endl;
+        return false;
+    }
+
+    if (!outFile.close()) {
+        cerr << "Error writing file: " << outputName << endl;
+        return false;
+    }
+    return true;
+}
+
+// Function to read the chunk index from the end of the file
+static bool readIndex(InputFile& inFile, vector<IndexEntry>& index, uint64_t& originalSize) {
+    uint64_t count, indexOffset;
+    if (!readTrailer(inFile, count, indexOffset, originalSize)) return false;
+
+    vector<uint8_t> scratch;
+    const uint8_t* entries;
+    if (!inFile.readAt(indexOffset, count * INDEX_ENTRY_SIZE, entries, scratch)) return false;
+
+    index.resize(count);
+    for (uint64_t i = 0; i < count; ++i) {
+        const uint8_t* entry = entries + i * INDEX_ENTRY_SIZE;
+        index[i] = { get64(entry), get32(entry + 8), get32(entry + 12) };
+    }
+    return true;
+}
+
+// Function to decompress only the bytes [offset, offset + length) of the
+// original file, decoding just the chunks that overlap that range
+bool extractRange(const string& inputName, uint64_t offset, uint64_t length, const string& outputName) {
+    InputFile inFile;
+    if (!inFile.open(inputName)) {
+        cerr << "Error opening file: " << inputName << endl;
+        return false;
+    }
+
+    uint32_t blockSize;
+    Decoders decoders;
+    vector<IndexEntry> index;
+    uint64_t originalSize;
+    if (!readHeader(inFile, blockSize, decoders) || !readIndex(inFile, index, originalSize)) {
+        cerr << "Not a seekable compressed file: " << inputName << endl;
+        return false;
+    }
+
+    OutputFile outFile;
+    if (!outFile.open(outputName)) {
+        cerr << "Error opening file: " << outputName << endl;
+        return false;
+    }
+
+    length = offset < originalSize ? min(length, originalSize - offset) : 0;
+
+    vector<uint8_t> scratch, raw;
+    while (length > 0) {
+        // Every chunk but the last is full, so the chunk number is a division
+        uint64_t number = offset / blockSize;
+        if (number >= index.size()) break;
+        const IndexEntry& entry = index[number];
+
+        const uint8_t* record;
+        ChunkView chunk = { 0, nullptr, entry.payloadSize, entry.rawSize };
+        raw.resize(entry.rawSize);
+        bool ok = entry.rawSize <= blockSize &&
+                  inFile.readAt(entry.offset, CHUNK_HEADER_SIZE + entry.payloadSize, record, scratch);
+        if (ok) {
+            chunk.method = record[8];
+            chunk.payload = record + CHUNK_HEADER_SIZE;
+            ok = decompressChunk(chunk, decoders, raw.data());
+        }
+        uint64_t start = offset - number * blockSize;
+        if (!ok || start >= raw.size()) {
+            cerr << "Corrupt data: " << inputName << endl;
+            return false;
+        }
+
+        uint64_t take = min<uint64_t>(length, raw.size() - start);
+        outFile.write(raw.data() + start, take);
+        offset += take;
+        length -= take;
+    }
+
+    if (!outFile.close()) {
+        cerr << "Error writing file: " << outputName << endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,47 @@
+#ifndef CONTAINER_H
+#define CONTAINER_H
+
+#include <string>
+#include <cstdint>
+#include <thread>
+
+using namespace std;
+
+// Compressed file layout (all integers little-endian):
+//
+//   header   "HUF3" | u8 flags | u32 blockSize | [128-byte shared code lengths]
+//   chunks   u32 rawSize | u32 payloadSize | u8 method | payload
+//            (method is a CoderMethod: stored, Huffman, tANS or LZ77 + Huffman)
+//   end      an all-zero chunk header
+//   index    per chunk: u64 offset of its header | u32 rawSize | u32 payloadSize
+//   trailer  u64 chunkCount | u64 indexOffset | u64 originalSize | "HIDX"
+//
+// Every chunk but the last holds exactly blockSize input bytes and decodes on
+// its own, so a reader can either stream chunks front to back or use the
+// index to seek straight to the chunk holding a given byte offset.
+
+const uint32_t DEFAULT_BLOCK_SIZE = 1 << 20;
+
+// Largest block size we accept, so chunk sizes always fit in 32 bits
+const uint32_t MAX_BLOCK_SIZE = 1 << 30;
+
+// Which entropy coders a chunk may use
+enum CoderChoice {
+    CODER_AUTO,    // whichever is expected to give the smaller chunk
+    CODER_HUFFMAN,
+    CODER_ANS
+};
+
+struct CompressOptions {
+    uint32_t blockSize = DEFAULT_BLOCK_SIZE;
+    unsigned threads = thread::hardware_concurrency();
+    bool sharedTable = false; // one Huffman table for the whole file instead of per chunk
+    CoderChoice coder = CODER_AUTO;
+    int level = 0;            // LZ77 match finding effort, 1-9; 0 codes bytes only
+};
+
+bool compressFile(const string& inputName, const string& outputName, const CompressOptions& options);
+bool decompressFile(const string& inputName, const string& outputName, unsigned threads);
+bool extractRange(const string& inputName, uint64_t offset, uint64_t length, const string& outputName);
+
+#endif
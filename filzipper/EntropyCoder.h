@@ -0,0 +1,36 @@
+#ifndef ENTROPYCODER_H
+#define ENTROPYCODER_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+const int ALPHABET_SIZE = 256;
+
+// Method byte stored in front of every chunk payload
+enum CoderMethod : uint8_t {
+    METHOD_STORED = 0,
+    METHOD_HUFFMAN = 1,
+    METHOD_ANS = 2,
+    METHOD_LZ77 = 3
+};
+
+// Order-0 entropy coder for one chunk. A payload holds everything needed to
+// decode it (its tables and the coded bits), unless the coder was set up
+// with tables shared by the whole file.
+class EntropyCoder {
+public:
+    virtual ~EntropyCoder() = default;
+    virtual CoderMethod method() const = 0;
+
+    // Expected payload size in bytes for a chunk with this histogram, used
+    // to pick the best coder without encoding the chunk twice
+    virtual size_t estimateSize(const uint64_t freq[ALPHABET_SIZE], size_t size) const = 0;
+
+    virtual void encode(const uint8_t* in, size_t size, const uint64_t freq[ALPHABET_SIZE], vector<uint8_t>& out) const = 0;
+    virtual bool decode(const uint8_t* in, size_t size, uint8_t* out, size_t originalSize) const = 0;
+};
+
+#endif
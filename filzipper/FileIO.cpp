@@ -0,0 +1,174 @@
+#include "FileIO.h"
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// Stdio buffer size for files that are not memory-mapped
+const size_t STREAM_BUFFER_SIZE = 1 << 20;
+
+static bool seekFile(FILE* file, uint64_t offset) {
+#ifdef _WIN32
+    return _fseeki64(file, offset, SEEK_SET) == 0;
+#else
+    return fseeko(file, offset, SEEK_SET) == 0;
+#endif
+}
+
+InputFile::~InputFile() {
+#ifndef _WIN32
+    if (mapping != nullptr) munmap(const_cast<uint8_t*>(mapping), fileSize);
+#endif
+    if (ownsFile) fclose(file);
+}
+
+bool InputFile::open(const string& name) {
+    if (name == "-") {
+        file = stdin;
+#ifdef _WIN32
+        _setmode(_fileno(stdin), _O_BINARY);
+#endif
+    } else {
+        file = fopen(name.c_str(), "rb");
+        if (file == nullptr) return false;
+        ownsFile = true;
+    }
+
+#ifndef _WIN32
+    // Regular files, including one redirected to stdin, are mapped whole
+    struct stat info;
+    if (fstat(fileno(file), &info) == 0 && S_ISREG(info.st_mode)) {
+        isSeekable = true;
+        fileSize = info.st_size;
+        if (fileSize == 0) {
+            isMapped = true;
+            return true;
+        }
+        void* map = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+        if (map != MAP_FAILED) {
+            madvise(map, fileSize, MADV_SEQUENTIAL);
+            mapping = static_cast<const uint8_t*>(map);
+            isMapped = true;
+            return true;
+        }
+    }
+#else
+    if (_fseeki64(file, 0, SEEK_END) == 0) {
+        isSeekable = true;
+        fileSize = _ftelli64(file);
+        _fseeki64(file, 0, SEEK_SET);
+    }
+#endif
+
+    setvbuf(file, nullptr, _IOFBF, STREAM_BUFFER_SIZE);
+    return true;
+}
+
+size_t InputFile::next(size_t n, const uint8_t*& data, vector<uint8_t>& scratch) {
+    if (isMapped) {
+        size_t got = min<uint64_t>(n, fileSize - pos);
+        data = mapping + pos;
+        pos += got;
+        return got;
+    }
+
+    scratch.resize(n);
+    size_t got = fread(scratch.data(), 1, n, file);
+    if (got < n && ferror(file)) error = true;
+    data = scratch.data();
+    pos += got;
+    return got;
+}
+
+bool InputFile::readAt(uint64_t offset, size_t n, const uint8_t*& data, vector<uint8_t>& scratch) {
+    if (offset > fileSize || n > fileSize - offset) return false;
+    if (isMapped) {
+        data = mapping + offset;
+        return true;
+    }
+    if (!isSeekable || !seekFile(file, offset)) return false;
+
+    scratch.resize(n);
+    data = scratch.data();
+    pos = offset + n;
+    return fread(scratch.data(), 1, n, file) == n;
+}
+
+bool InputFile::rewind() {
+    if (!isSeekable) return false;
+    pos = 0;
+    return isMapped || seekFile(file, 0);
+}
+
+OutputFile::~OutputFile() {
+    close();
+}
+
+bool OutputFile::open(const string& name) {
+    if (name == "-") {
+        file = stdout;
+#ifdef _WIN32
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    } else {
+        file = fopen(name.c_str(), "wb");
+        if (file == nullptr) return false;
+        ownsFile = true;
+    }
+
+    setvbuf(file, nullptr, _IOFBF, STREAM_BUFFER_SIZE);
+    return true;
+}
+
+bool OutputFile::openMapped(const string& name, uint64_t size) {
+#ifndef _WIN32
+    if (name != "-" && size > 0) {
+        int fd = ::open(name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+
+        void* map = MAP_FAILED;
+        if (ftruncate(fd, size) == 0) {
+            map = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        ::close(fd);
+        if (map != MAP_FAILED) {
+            mapping = static_cast<uint8_t*>(map);
+            mappedSize = size;
+            isMapped = true;
+            return true;
+        }
+    }
+#endif
+    return open(name);
+}
+
+bool OutputFile::write(const uint8_t* data, size_t n) {
+    if (isMapped || file == nullptr) return false;
+    if (fwrite(data, 1, n, file) != n) error = true;
+    return !error;
+}
+
+// Flushes and releases the file, returning false if any write failed
+bool OutputFile::close() {
+#ifndef _WIN32
+    if (mapping != nullptr) {
+        if (munmap(mapping, mappedSize) != 0) error = true;
+        mapping = nullptr;
+    }
+#endif
+    if (file != nullptr) {
+        if (fflush(file) != 0) error = true;
+        if (ownsFile && fclose(file) != 0) error = true;
+        file = nullptr;
+        ownsFile = false;
+    }
+    return !error;
+}
@@ -0,0 +1,75 @@
+#ifndef FILEIO_H
+#define FILEIO_H
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+// Input file that is memory-mapped when it is a regular file, so reads hand
+// out pointers straight into the mapping, and read through a large stdio
+// buffer otherwise (pipes, terminals). The name "-" means stdin.
+class InputFile {
+public:
+    InputFile() = default;
+    ~InputFile();
+    InputFile(const InputFile&) = delete;
+    InputFile& operator=(const InputFile&) = delete;
+
+    bool open(const string& name);
+    bool mapped() const { return isMapped; }
+    bool seekable() const { return isSeekable; }
+    uint64_t size() const { return fileSize; }
+    bool failed() const { return error; }
+
+    // Reads up to n bytes (fewer only at the end of the file) and points
+    // `data` at them: into the mapping when mapped, else into `scratch`
+    size_t next(size_t n, const uint8_t*& data, vector<uint8_t>& scratch);
+
+    // Random access for seekable files; both fail on pipes
+    bool readAt(uint64_t offset, size_t n, const uint8_t*& data, vector<uint8_t>& scratch);
+    bool rewind();
+
+private:
+    FILE* file = nullptr;
+    bool ownsFile = false;
+    const uint8_t* mapping = nullptr;
+    bool isMapped = false;
+    bool isSeekable = false;
+    bool error = false;
+    uint64_t fileSize = 0;
+    uint64_t pos = 0;
+};
+
+// Output file written through a large stdio buffer, or memory-mapped at a
+// known final size so workers can write their results in place. The name
+// "-" means stdout, which is never mapped.
+class OutputFile {
+public:
+    OutputFile() = default;
+    ~OutputFile();
+    OutputFile(const OutputFile&) = delete;
+    OutputFile& operator=(const OutputFile&) = delete;
+
+    bool open(const string& name);
+    // Falls back to open() when the file cannot be mapped
+    bool openMapped(const string& name, uint64_t size);
+    bool mapped() const { return isMapped; }
+    uint8_t* data() { return mapping; }
+
+    bool write(const uint8_t* data, size_t n);
+    bool close();
+
+private:
+    FILE* file = nullptr;
+    bool ownsFile = false;
+    uint8_t* mapping = nullptr;
+    bool isMapped = false;
+    bool error = false;
+    uint64_t mappedSize = 0;
+};
+
+#endif
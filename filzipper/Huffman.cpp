@@ -0,0 +1,290 @@
+#include "Huffman.h"
+#include <algorithm>
+#include <cstring>
+
+// Function to add the bytes of a buffer to a byte histogram
+void addToHistogram(const uint8_t* data, size_t size, uint64_t freq[ALPHABET_SIZE]) {
+    for (size_t i = 0; i < size; ++i) {
+        freq[data[i]]++;
+    }
+}
+
+// Function to build Huffman tree from a full histogram with the
+// two-queue method: leaves sorted by frequency form the first queue, and
+// merged nodes are created in non-decreasing frequency order, so they form
+// the second queue for free. The cheapest node is always at one of the fronts.
+void buildHuffmanTree(const uint64_t* freq, HuffmanTree& tree, int symbols) {
+    tree.size = 0;
+    tree.root = NO_CHILD;
+
+    for (int i = 0; i < symbols; ++i) {
+        if (freq[i] > 0) {
+            tree.nodes[tree.size++] = { freq[i], NO_CHILD, NO_CHILD, static_cast<uint16_t>(i) };
+        }
+    }
+
+    uint16_t leaves = tree.size;
+    if (leaves == 0) return;
+
+    stable_sort(tree.nodes, tree.nodes + leaves, [](const Node& a, const Node& b) { return a.freq < b.freq; });
+
+    uint16_t nextLeaf = 0, nextMerged = leaves;
+    auto takeSmallest = [&]() -> uint16_t {
+        if (nextLeaf < leaves && (nextMerged == tree.size || tree.nodes[nextLeaf].freq <= tree.nodes[nextMerged].freq)) {
+            return nextLeaf++;
+        }
+        return nextMerged++;
+    };
+
+    while (tree.size < 2 * leaves - 1) {
+        uint16_t left = takeSmallest();
+        uint16_t right = takeSmallest();
+        tree.nodes[tree.size] = { tree.nodes[left].freq + tree.nodes[right].freq, left, right, 0 };
+        tree.size++;
+    }
+
+    tree.root = tree.size - 1;
+}
+
+// Function to record the depth of every leaf as its code length. Parents
+// always come after their children, so one backwards sweep sets all depths.
+void computeCodeLengths(const HuffmanTree& tree, uint8_t* lengths) {
+    if (tree.root == NO_CHILD) return;
+
+    if (tree.size == 1) {
+        // A lone symbol still needs one bit per occurrence
+        lengths[tree.nodes[0].symbol] = 1;
+        return;
+    }
+
+    uint8_t depth[MAX_NODES];
+    depth[tree.root] = 0;
+    for (int i = tree.root; i >= 0; --i) {
+        const Node& node = tree.nodes[i];
+        if (node.left == NO_CHILD) {
+            lengths[node.symbol] = depth[i];
+        } else {
+            depth[node.left] = depth[i] + 1;
+            depth[node.right] = depth[i] + 1;
+        }
+    }
+}
+
+// Function to cap code lengths at maxLength while keeping a valid prefix code.
+// Overlong codes are clamped, then the shortest possible codes are lengthened
+// until the Kraft sum fits again; lengths go to symbols by descending frequency.
+void limitCodeLengths(const uint64_t* freq, uint8_t* lengths, int maxLength, int symbols) {
+    int count[256] = {};
+    bool overflow = false;
+    for (int i = 0; i < symbols; ++i) {
+        if (lengths[i] > maxLength) overflow = true;
+        count[min<int>(lengths[i], maxLength)]++;
+    }
+    if (!overflow) return;
+
+    uint64_t total = 0;
+    for (int len = maxLength; len > 0; --len) {
+        total += static_cast<uint64_t>(count[len]) << (maxLength - len);
+    }
+    while (total > (1ULL << maxLength)) {
+        count[maxLength]--;
+        for (int len = maxLength - 1; len > 0; --len) {
+            if (count[len] > 0) {
+                count[len]--;
+                count[len + 1] += 2;
+                break;
+            }
+        }
+        total--;
+    }
+
+    vector<int> used;
+    for (int i = 0; i < symbols; ++i) {
+        if (lengths[i] > 0) used.push_back(i);
+    }
+    stable_sort(used.begin(), used.end(), [&](int a, int b) { return freq[a] > freq[b]; });
+
+    size_t next = 0;
+    for (int len = 1; len <= maxLength; ++len) {
+        for (int k = 0; k < count[len]; ++k) {
+            lengths[used[next++]] = len;
+        }
+    }
+}
+
+// Function to turn a histogram into length-limited Huffman code lengths
+void buildCodeLengths(const uint64_t* freq, uint8_t* lengths, int symbols) {
+    fill(lengths, lengths + symbols, 0);
+
+    HuffmanTree tree;
+    buildHuffmanTree(freq, tree, symbols);
+    computeCodeLengths(tree, lengths);
+    limitCodeLengths(freq, lengths, MAX_CODE_LENGTH, symbols);
+}
+
+// Function to generate canonical Huffman codes from the code lengths alone,
+// so the decoder can rebuild exactly the same codes from the header
+void generateCodes(const uint8_t* lengths, CodeTable& table, int symbols) {
+    uint32_t code = 0;
+    int prevLen = 0;
+
+    for (int len = 1; len <= MAX_CODE_LENGTH; ++len) {
+        for (int i = 0; i < symbols; ++i) {
+            if (lengths[i] != len) continue;
+
+            code <<= (len - prevLen);
+            prevLen = len;
+            table.code[i] = code++;
+        }
+    }
+
+    copy(lengths, lengths + symbols, table.len);
+}
+
+// Function to build the decode table from the code lengths in the header,
+// returning false if the lengths do not describe a valid prefix code
+bool buildDecodeTable(const uint8_t* lengths, DecodeTable& table, int symbols) {
+    fill(table.entry, table.entry + (1 << LOOKUP_BITS), 0);
+    fill(table.count, table.count + MAX_CODE_LENGTH + 1, 0);
+
+    uint32_t kraft = 0;
+    for (int i = 0; i < symbols; ++i) {
+        if (lengths[i] > MAX_CODE_LENGTH) return false;
+        if (lengths[i] > 0) {
+            table.count[lengths[i]]++;
+            kraft += 1u << (MAX_CODE_LENGTH - lengths[i]);
+        }
+    }
+    if (kraft > (1u << MAX_CODE_LENGTH)) return false;
+
+    uint32_t code = 0;
+    uint16_t index = 0;
+    for (int len = 1; len <= MAX_CODE_LENGTH; ++len) {
+        table.firstCode[len] = code;
+        table.firstIndex[len] = index;
+        code = (code + table.count[len]) << 1;
+        index += table.count[len];
+    }
+
+    CodeTable codes;
+    generateCodes(lengths, codes, symbols);
+
+    uint16_t next[MAX_CODE_LENGTH + 1];
+    copy(table.firstIndex, table.firstIndex + MAX_CODE_LENGTH + 1, next);
+    for (int i = 0; i < symbols; ++i) {
+        int len = lengths[i];
+        if (len == 0) continue;
+
+        table.sorted[next[len]++] = static_cast<uint16_t>(i);
+        if (len <= LOOKUP_BITS) {
+            uint32_t base = codes.code[i] << (LOOKUP_BITS - len);
+            for (uint32_t k = 0; k < (1u << (LOOKUP_BITS - len)); ++k) {
+                table.entry[base + k] = static_cast<uint16_t>(i | (len << ENTRY_SYMBOL_BITS));
+            }
+        }
+    }
+
+    return true;
+}
+
+// Function to pack code lengths two 4-bit values per byte
+void packLengths(const uint8_t* lengths, uint8_t* packed, int symbols) {
+    for (int i = 0; i < symbols; i += 2) {
+        uint8_t high = i + 1 < symbols ? lengths[i + 1] : 0;
+        packed[i / 2] = static_cast<uint8_t>(lengths[i] | (high << 4));
+    }
+}
+
+// Function to unpack code lengths stored by packLengths
+void unpackLengths(const uint8_t* packed, uint8_t* lengths, int symbols) {
+    for (int i = 0; i < symbols; ++i) {
+        lengths[i] = (i % 2 == 0) ? (packed[i / 2] & 0x0F) : (packed[i / 2] >> 4);
+    }
+}
+
+// Function to encode a buffer using Huffman codes, appending to `out`
+void encodeText(const uint8_t* in, size_t size, const CodeTable& table, vector<uint8_t>& out) {
+    // Worst case is MAX_CODE_LENGTH bits per byte plus the flushed tail
+    size_t start = out.size();
+    out.resize(start + (size * MAX_CODE_LENGTH + 7) / 8 + 8);
+
+    BitWriter writer(out.data() + start);
+    for (size_t i = 0; i < size; ++i) {
+        writer.put(table.code[in[i]], table.len[in[i]]);
+    }
+    writer.finish();
+
+    out.resize(start + writer.used);
+}
+
+// Function to decode Huffman encoded text with the table-driven decoder,
+// returning false if the bit stream contains an invalid code
+bool decodeText(const uint8_t* in, size_t size, const DecodeTable& table, uint8_t* out, size_t originalSize) {
+    BitReader reader(in, size);
+
+    for (size_t decodedSize = 0; decodedSize < originalSize; ++decodedSize) {
+        reader.refill();
+
+        int symbol = decodeSymbol(reader, table);
+        if (symbol < 0) return false;
+        out[decodedSize] = static_cast<uint8_t>(symbol);
+    }
+
+    return true;
+}
+
+// Function to use one set of code lengths for every chunk of a file,
+// returning false if they do not describe a valid prefix code
+bool HuffmanCoder::setSharedLengths(const uint8_t lengths[ALPHABET_SIZE]) {
+    copy(lengths, lengths + ALPHABET_SIZE, sharedLengths);
+    generateCodes(sharedLengths, sharedCodes);
+    shared = buildDecodeTable(sharedLengths, sharedTable);
+    return shared;
+}
+
+size_t HuffmanCoder::estimateSize(const uint64_t freq[ALPHABET_SIZE], size_t) const {
+    uint8_t lengths[ALPHABET_SIZE];
+    if (shared) {
+        copy(sharedLengths, sharedLengths + ALPHABET_SIZE, lengths);
+    } else {
+        buildCodeLengths(freq, lengths);
+    }
+
+    uint64_t bits = 0;
+    for (int i = 0; i < ALPHABET_SIZE; ++i) {
+        bits += freq[i] * lengths[i];
+    }
+    return (bits + 7) / 8 + (shared ? 0 : PACKED_LENGTHS_SIZE);
+}
+
+void HuffmanCoder::encode(const uint8_t* in, size_t size, const uint64_t freq[ALPHABET_SIZE], vector<uint8_t>& out) const {
+    if (shared) {
+        encodeText(in, size, sharedCodes, out);
+        return;
+    }
+
+    uint8_t lengths[ALPHABET_SIZE];
+    buildCodeLengths(freq, lengths);
+
+    uint8_t packed[PACKED_LENGTHS_SIZE];
+    packLengths(lengths, packed);
+    out.insert(out.end(), packed, packed + PACKED_LENGTHS_SIZE);
+
+    CodeTable table;
+    generateCodes(lengths, table);
+    encodeText(in, size, table, out);
+}
+
+bool HuffmanCoder::decode(const uint8_t* in, size_t size, uint8_t* out, size_t originalSize) const {
+    if (shared) {
+        return decodeText(in, size, sharedTable, out, originalSize);
+    }
+
+    if (size < PACKED_LENGTHS_SIZE) return false;
+    uint8_t lengths[ALPHABET_SIZE];
+    unpackLengths(in, lengths);
+
+    DecodeTable table;
+    if (!buildDecodeTable(lengths, table)) return false;
+    return decodeText(in + PACKED_LENGTHS_SIZE, size - PACKED_LENGTHS_SIZE, table, out, originalSize);
+}
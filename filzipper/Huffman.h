@@ -0,0 +1,119 @@
+#ifndef HUFFMAN_H
+#define HUFFMAN_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "EntropyCoder.h"
+#include "BitStream.h"
+
+using namespace std;
+
+// Largest alphabet the Huffman code supports: bytes, or the 286 LZ77
+// literal/length symbols
+const int MAX_SYMBOLS = 286;
+
+// Longest code we emit, so code lengths fit in a nibble of the header
+const int MAX_CODE_LENGTH = 15;
+
+// Codes up to this length are resolved by a single decode table lookup
+const int LOOKUP_BITS = 11;
+
+// Size of a nibble-packed code length table for the byte alphabet
+const size_t PACKED_LENGTHS_SIZE = ALPHABET_SIZE / 2;
+
+// An alphabet of n symbols never needs more than 2n - 1 tree nodes
+const int MAX_NODES = 2 * MAX_SYMBOLS - 1;
+const uint16_t NO_CHILD = 0xFFFF;
+
+// Node structure for Huffman tree; children are indices into the tree's
+// node array, NO_CHILD for leaves
+struct Node {
+    uint64_t freq;
+    uint16_t left, right;
+    uint16_t symbol;
+};
+
+// Huffman tree owning all of its nodes in one fixed array. Leaves come
+// first, then internal nodes in creation order, so the root is last.
+struct HuffmanTree {
+    Node nodes[MAX_NODES];
+    uint16_t size = 0;
+    uint16_t root = NO_CHILD;
+};
+
+// Flat code table: code bits (right-aligned) and bit length per symbol
+struct CodeTable {
+    uint32_t code[MAX_SYMBOLS];
+    uint8_t len[MAX_SYMBOLS];
+};
+
+// Decode table: the next LOOKUP_BITS bits index `entry`, which holds the
+// symbol in the low 9 bits and the code length above them (0 for longer
+// codes). Longer codes fall back to the canonical first-code/offset arrays.
+struct DecodeTable {
+    uint16_t entry[1 << LOOKUP_BITS];
+    uint32_t firstCode[MAX_CODE_LENGTH + 1];
+    uint16_t firstIndex[MAX_CODE_LENGTH + 1];
+    uint16_t count[MAX_CODE_LENGTH + 1];
+    uint16_t sorted[MAX_SYMBOLS];
+};
+
+const int ENTRY_SYMBOL_BITS = 9;
+const uint16_t ENTRY_SYMBOL_MASK = (1 << ENTRY_SYMBOL_BITS) - 1;
+
+void addToHistogram(const uint8_t* data, size_t size, uint64_t freq[ALPHABET_SIZE]);
+void buildHuffmanTree(const uint64_t* freq, HuffmanTree& tree, int symbols = ALPHABET_SIZE);
+void computeCodeLengths(const HuffmanTree& tree, uint8_t* lengths);
+void limitCodeLengths(const uint64_t* freq, uint8_t* lengths, int maxLength, int symbols = ALPHABET_SIZE);
+void buildCodeLengths(const uint64_t* freq, uint8_t* lengths, int symbols = ALPHABET_SIZE);
+void generateCodes(const uint8_t* lengths, CodeTable& table, int symbols = ALPHABET_SIZE);
+bool buildDecodeTable(const uint8_t* lengths, DecodeTable& table, int symbols = ALPHABET_SIZE);
+
+void packLengths(const uint8_t* lengths, uint8_t* packed, int symbols = ALPHABET_SIZE);
+void unpackLengths(const uint8_t* packed, uint8_t* lengths, int symbols = ALPHABET_SIZE);
+
+void encodeText(const uint8_t* in, size_t size, const CodeTable& table, vector<uint8_t>& out);
+bool decodeText(const uint8_t* in, size_t size, const DecodeTable& table, uint8_t* out, size_t originalSize);
+
+// Function to decode one symbol from a refilled reader, returning -1 for
+// an invalid code
+inline int decodeSymbol(BitReader& reader, const DecodeTable& table) {
+    uint16_t entry = table.entry[reader.peek(LOOKUP_BITS)];
+    int len = entry >> ENTRY_SYMBOL_BITS;
+    int symbol = entry & ENTRY_SYMBOL_MASK;
+
+    if (len == 0) {
+        // Long code: find its length from the canonical first codes
+        for (len = LOOKUP_BITS + 1; len <= MAX_CODE_LENGTH; ++len) {
+            uint32_t offset = reader.peek(len) - table.firstCode[len];
+            if (offset < table.count[len]) {
+                symbol = table.sorted[table.firstIndex[len] + offset];
+                break;
+            }
+        }
+        if (len > MAX_CODE_LENGTH) return -1;
+    }
+
+    reader.consume(len);
+    return symbol;
+}
+
+// Huffman backend: payloads start with the packed code lengths, unless
+// the coder holds code lengths shared by the whole file
+class HuffmanCoder : public EntropyCoder {
+public:
+    bool setSharedLengths(const uint8_t lengths[ALPHABET_SIZE]);
+
+    CoderMethod method() const override { return METHOD_HUFFMAN; }
+    size_t estimateSize(const uint64_t freq[ALPHABET_SIZE], size_t size) const override;
+    void encode(const uint8_t* in, size_t size, const uint64_t freq[ALPHABET_SIZE], vector<uint8_t>& out) const override;
+    bool decode(const uint8_t* in, size_t size, uint8_t* out, size_t originalSize) const override;
+private:
+    bool shared = false;
+    uint8_t sharedLengths[ALPHABET_SIZE];
+    CodeTable sharedCodes;
+    DecodeTable sharedTable;
+};
+
+#endif
@@ -0,0 +1,266 @@
+#include "Lz77.h"
+#include "Huffman.h"
+#include <algorithm>
+#include <cstring>
+
+const int LENGTH_CODES = 29;
+const size_t PACKED_LITLEN_SIZE = (LITLEN_SYMBOLS + 1) / 2;
+const size_t PACKED_DIST_SIZE = (DIST_SYMBOLS + 1) / 2;
+
+const int HASH_BITS = 15;
+const int WINDOW_MASK = LZ_WINDOW_SIZE - 1;
+
+// A 3-byte match this far back costs more than three literals
+const int TOO_FAR = 4096;
+
+// Tokens are literals (< 256) or MATCH_FLAG | length << 16 | (distance - 1)
+const uint32_t MATCH_FLAG = 0x80000000u;
+
+static const uint16_t lengthBase[LENGTH_CODES] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const uint8_t lengthExtra[LENGTH_CODES] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const uint16_t distBase[DIST_SYMBOLS] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129,
+    193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const uint8_t distExtra[DIST_SYMBOLS] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6,
+    6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+// Match finder effort per level: how many chain links to follow, when a
+// match is good enough to stop looking, and whether to try lazy matching
+struct LevelParams {
+    int maxChain;
+    int niceLength;
+    bool lazy;
+};
+
+static const LevelParams levels[MAX_LEVEL + 1] = {
+    { 0, 0, false },
+    { 4, 16, false }, { 8, 32, false }, { 16, 64, false },
+    { 16, 32, true }, { 32, 64, true }, { 64, 128, true },
+    { 128, 258, true }, { 512, 258, true }, { 4096, 258, true }
+};
+
+// Function to map a match length (3..258) to its length code (0..28)
+static int lengthCode(int length) {
+    static const struct Table {
+        uint8_t code[LZ_MAX_MATCH + 1];
+        Table() {
+            for (int c = 0; c < LENGTH_CODES; ++c) {
+                int last = c + 1 < LENGTH_CODES ? lengthBase[c + 1] : LZ_MAX_MATCH + 1;
+                for (int len = lengthBase[c]; len < last; ++len) code[len] = static_cast<uint8_t>(c);
+            }
+            code[LZ_MAX_MATCH] = LENGTH_CODES - 1;
+        }
+    } table;
+    return table.code[length];
+}
+
+// Function to map a distance (1..32768) to its distance code (0..29)
+static int distCode(int distance) {
+    uint32_t d = distance - 1;
+    if (d < 4) return d;
+    int high = 0;
+    while (d >> (high + 1)) high++;
+    return 2 * high + ((d >> (high - 1)) & 1);
+}
+
+static uint32_t hash3(const uint8_t* p) {
+    uint32_t value = (static_cast<uint32_t>(p[0]) << 16) | (p[1] << 8) | p[2];
+    return (value * 2654435761u) >> (32 - HASH_BITS);
+}
+
+// Hash chains over the last LZ_WINDOW_SIZE positions: head holds the latest
+// position for each hash and prev links every position to the one before it
+struct MatchFinder {
+    const uint8_t* in;
+    size_t size;
+    LevelParams params;
+    vector<int32_t> head;
+    vector<int32_t> prev;
+
+    MatchFinder(const uint8_t* data, size_t n, const LevelParams& p)
+        : in(data), size(n), params(p), head(1 << HASH_BITS, -1), prev(LZ_WINDOW_SIZE, -1) {}
+
+    void insert(size_t pos) {
+        if (pos + LZ_MIN_MATCH > size) return;
+        uint32_t h = hash3(in + pos);
+        prev[pos & WINDOW_MASK] = head[h];
+        head[h] = static_cast<int32_t>(pos);
+    }
+
+    // Returns the longest match length at pos (0 if none) and sets distance
+    int find(size_t pos, int& distance) const {
+        if (pos + LZ_MIN_MATCH > size) return 0;
+        int limit = static_cast<int>(min<size_t>(LZ_MAX_MATCH, size - pos));
+        const uint8_t* cur = in + pos;
+
+        int best = LZ_MIN_MATCH - 1;
+        int chain = params.maxChain;
+        int32_t cand = head[hash3(cur)];
+        while (cand >= 0 && pos - cand <= static_cast<size_t>(LZ_WINDOW_SIZE) && chain-- > 0) {
+            const uint8_t* match = in + cand;
+            // Check the byte that would extend the best match first
+            if (match[best] == cur[best] && match[0] == cur[0]) {
+                int len = 0;
+                while (len < limit && match[len] == cur[len]) len++;
+                if (len > best) {
+                    best = len;
+                    distance = static_cast<int>(pos - cand);
+                    if (len >= params.niceLength || len == limit) break;
+                }
+            }
+            int32_t next = prev[cand & WINDOW_MASK];
+            if (next >= cand) break; // slot reused by a newer position
+            cand = next;
+        }
+
+        if (best < LZ_MIN_MATCH) return 0;
+        if (best == LZ_MIN_MATCH && distance > TOO_FAR) return 0;
+        return best;
+    }
+};
+
+// Function to split a buffer into literal and match tokens
+static void findTokens(const uint8_t* in, size_t size, const LevelParams& params, vector<uint32_t>& tokens) {
+    MatchFinder finder(in, size, params);
+
+    size_t pos = 0;
+    while (pos < size) {
+        int distance = 0;
+        int length = finder.find(pos, distance);
+        finder.insert(pos);
+
+        // Lazy matching: emit a literal if the next position matches longer
+        if (params.lazy && length > 0 && length < params.niceLength) {
+            int nextDistance = 0;
+            if (finder.find(pos + 1, nextDistance) > length) {
+                tokens.push_back(in[pos++]);
+                continue;
+            }
+        }
+
+        if (length == 0) {
+            tokens.push_back(in[pos++]);
+            continue;
+        }
+
+        tokens.push_back(MATCH_FLAG | (static_cast<uint32_t>(length) << 16) | (distance - 1));
+        for (int k = 1; k < length; ++k) finder.insert(pos + k);
+        pos += length;
+    }
+}
+
+Lz77Coder::Lz77Coder(int level) : level(max(MIN_LEVEL, min(MAX_LEVEL, level))) {}
+
+void Lz77Coder::encode(const uint8_t* in, size_t size, vector<uint8_t>& out) const {
+    vector<uint32_t> tokens;
+    tokens.reserve(size / 2 + 16);
+    findTokens(in, size, levels[level], tokens);
+
+    uint64_t litlenFreq[LITLEN_SYMBOLS] = {};
+    uint64_t distFreq[DIST_SYMBOLS] = {};
+    for (uint32_t token : tokens) {
+        if (token & MATCH_FLAG) {
+            litlenFreq[257 + lengthCode((token >> 16) & 0x1FF)]++;
+            distFreq[distCode((token & 0xFFFF) + 1)]++;
+        } else {
+            litlenFreq[token]++;
+        }
+    }
+
+    uint8_t litlenLengths[LITLEN_SYMBOLS];
+    uint8_t distLengths[DIST_SYMBOLS];
+    buildCodeLengths(litlenFreq, litlenLengths, LITLEN_SYMBOLS);
+    buildCodeLengths(distFreq, distLengths, DIST_SYMBOLS);
+
+    size_t start = out.size();
+    out.resize(start + PACKED_LITLEN_SIZE + PACKED_DIST_SIZE);
+    packLengths(litlenLengths, out.data() + start, LITLEN_SYMBOLS);
+    packLengths(distLengths, out.data() + start + PACKED_LITLEN_SIZE, DIST_SYMBOLS);
+
+    CodeTable litlenCodes, distCodes;
+    generateCodes(litlenLengths, litlenCodes, LITLEN_SYMBOLS);
+    generateCodes(distLengths, distCodes, DIST_SYMBOLS);
+
+    // A literal takes at most 15 bits, a match of 3+ bytes at most 48
+    size_t bits = out.size();
+    out.resize(bits + 2 * size + 8);
+    BitWriter writer(out.data() + bits);
+    for (uint32_t token : tokens) {
+        if (!(token & MATCH_FLAG)) {
+            writer.put(litlenCodes.code[token], litlenCodes.len[token]);
+            continue;
+        }
+
+        int length = (token >> 16) & 0x1FF;
+        int distance = (token & 0xFFFF) + 1;
+        int lc = lengthCode(length);
+        int dc = distCode(distance);
+        writer.put(litlenCodes.code[257 + lc], litlenCodes.len[257 + lc]);
+        writer.put(length - lengthBase[lc], lengthExtra[lc]);
+        writer.put(distCodes.code[dc], distCodes.len[dc]);
+        writer.put(distance - distBase[dc], distExtra[dc]);
+    }
+    writer.finish();
+
+    out.resize(bits + writer.used);
+}
+
+bool Lz77Coder::decode(const uint8_t* in, size_t size, uint8_t* out, size_t originalSize) const {
+    if (size < PACKED_LITLEN_SIZE + PACKED_DIST_SIZE) return false;
+
+    uint8_t litlenLengths[LITLEN_SYMBOLS];
+    uint8_t distLengths[DIST_SYMBOLS];
+    unpackLengths(in, litlenLengths, LITLEN_SYMBOLS);
+    unpackLengths(in + PACKED_LITLEN_SIZE, distLengths, DIST_SYMBOLS);
+
+    DecodeTable litlenTable, distTable;
+    if (!buildDecodeTable(litlenLengths, litlenTable, LITLEN_SYMBOLS)) return false;
+    if (!buildDecodeTable(distLengths, distTable, DIST_SYMBOLS)) return false;
+
+    size_t header = PACKED_LITLEN_SIZE + PACKED_DIST_SIZE;
+    BitReader reader(in + header, size - header);
+
+    size_t produced = 0;
+    while (produced < originalSize) {
+        // One refill covers a whole match: at most 15 + 5 + 15 + 13 bits
+        reader.refill();
+
+        int symbol = decodeSymbol(reader, litlenTable);
+        if (symbol < 0) return false;
+        if (symbol < 256) {
+            out[produced++] = static_cast<uint8_t>(symbol);
+            continue;
+        }
+        if (symbol == 256) return false;
+
+        int lc = symbol - 257;
+        size_t length = lengthBase[lc] + reader.read(lengthExtra[lc]);
+
+        int dc = decodeSymbol(reader, distTable);
+        if (dc < 0) return false;
+        size_t distance = distBase[dc] + reader.read(distExtra[dc]);
+
+        if (distance > produced || length > originalSize - produced) return false;
+
+        uint8_t* dst = out + produced;
+        const uint8_t* src = dst - distance;
+        if (distance >= length) {
+            memcpy(dst, src, length);
+        } else {
+            // Overlapping copy repeats the last `distance` bytes
+            for (size_t k = 0; k < length; ++k) dst[k] = src[k];
+        }
+        produced += length;
+    }
+
+    return true;
+}
@@ -0,0 +1,40 @@
+#ifndef LZ77_H
+#define LZ77_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+// Matches reach back at most this far, and are 3 to 258 bytes long
+const int LZ_WINDOW_SIZE = 1 << 15;
+const int LZ_MIN_MATCH = 3;
+const int LZ_MAX_MATCH = 258;
+
+// Literal/length alphabet: 0-255 literals, 257-285 length codes (256 is
+// unused, the chunk size ends the stream); distance alphabet: 30 codes.
+// Length and distance codes carry extra bits exactly as in deflate.
+const int LITLEN_SYMBOLS = 286;
+const int DIST_SYMBOLS = 30;
+
+const int MIN_LEVEL = 1;
+const int MAX_LEVEL = 9;
+
+// LZ77 + Huffman coder (a deflate-like pipeline). A hash-chain match finder
+// turns the chunk into literals and (length, distance) matches, which are
+// then coded with separate Huffman tables for literals/lengths and for
+// distances. Higher levels follow longer hash chains and use lazy matching.
+//
+// Payload: packed literal/length code lengths (143 bytes) |
+//          packed distance code lengths (15 bytes) | coded bits
+class Lz77Coder {
+public:
+    Lz77Coder(int level = 6);
+    void encode(const uint8_t* in, size_t size, vector<uint8_t>& out) const;
+    bool decode(const uint8_t* in, size_t size, uint8_t* out, size_t originalSize) const;
+private:
+    int level;
+};
+
+#endif
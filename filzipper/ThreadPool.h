@@ -0,0 +1,33 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+using namespace std;
+
+// Fixed-size pool of worker threads running queued tasks
+class ThreadPool {
+public:
+    ThreadPool(unsigned threads);
+    ~ThreadPool();
+    void submit(function<void()> task);
+    void wait();
+    unsigned size() const { return workers.size(); }
+private:
+    void run();
+
+    vector<thread> workers;
+    queue<function<void()>> tasks;
+    mutex lock;
+    condition_variable taskReady;
+    condition_variable allDone;
+    size_t pending = 0;
+    bool stopping = false;
+};
+
+#endif
@@ -0,0 +1,453 @@
+// Compression benchmark: codes each corpus file (and a few generated data
+// sets) block by block, the way the container does, and reports per-phase
+// throughput, compression ratio, peak RSS and a round-trip check as CSV or
+// JSON, so runs of different versions can be compared.
+//
+// Each data set and coder runs in a child process of its own, which loads
+// or generates the data itself, so the peak RSS of a row is that run's
+// alone (on Windows, where RSS is not reported, the runs happen in-process).
+//
+// Build from the filzipper directory:
+//   g++ -O2 -std=c++17 -pthread bench/bench.cpp Huffman.cpp Ans.cpp Lz77.cpp -o bench
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <array>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include "../Huffman.h"
+#include "../Ans.h"
+#include "../Lz77.h"
+#include "../Container.h"
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+const size_t GENERATED_SIZE = 8 << 20;
+
+struct Dataset {
+    string name;
+    vector<uint8_t> data;
+};
+
+// A data set to benchmark: generated, or read from a corpus file when
+// `generate` is null
+struct DatasetSpec {
+    string name;
+    Dataset (*generate)();
+};
+
+// What one run measures; throughputs are input MB/s, negative when the
+// coder has no separate phase for it
+struct Measurement {
+    size_t rawSize = 0;
+    size_t packedSize = 0;
+    double histogramMBps = -1;
+    double treeMBps = -1;
+    double encodeMBps = -1;
+    double decodeMBps = -1;
+    bool roundTrip = false;
+    long peakRssKiB = 0;
+};
+
+// One benchmark row
+struct Result : Measurement {
+    string dataset;
+    string coder;
+};
+
+static double now() {
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static double mbps(size_t bytes, double seconds) {
+    return seconds > 0 ? bytes / seconds / 1e6 : 0;
+}
+
+// Peak resident set size of the process so far
+static long peakRssKiB() {
+#ifndef _WIN32
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+#else
+    return 0;
+#endif
+}
+
+static bool loadFile(const string& name, vector<uint8_t>& data) {
+    ifstream in(name, ios::binary);
+    if (!in) return false;
+    data.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    return !in.bad();
+}
+
+// Uniform random bytes: incompressible, so every chunk should be stored
+static Dataset randomData() {
+    Dataset set{ "random", vector<uint8_t>(GENERATED_SIZE) };
+    mt19937 rng(1);
+    for (uint8_t& byte : set.data) byte = static_cast<uint8_t>(rng());
+    return set;
+}
+
+// Geometrically distributed bytes: very skewed, where tANS beats Huffman
+static Dataset skewedData() {
+    Dataset set{ "skewed", vector<uint8_t>(GENERATED_SIZE) };
+    mt19937 rng(2);
+    geometric_distribution<int> dist(0.2);
+    for (uint8_t& byte : set.data) byte = static_cast<uint8_t>(min(dist(rng), 255));
+    return set;
+}
+
+// Log-like text built from a small vocabulary: repetitive, where LZ77 wins
+static Dataset textData() {
+    static const char* words[] = {
+        "request", "served", "from", "cache", "user", "login", "failed", "retry", "timeout",
+        "GET", "POST", "/api/v1/items", "/index.html", "status", "200", "404", "500", "ms"
+    };
+    const int wordCount = sizeof(words) / sizeof(words[0]);
+
+    Dataset set{ "text", {} };
+    set.data.reserve(GENERATED_SIZE + 256);
+    mt19937 rng(3);
+    string line;
+    for (unsigned n = 0; set.data.size() < GENERATED_SIZE; ++n) {
+        line = "2024-01-01 12:" + to_string(n / 60 % 60) + ":" + to_string(n % 60) + " [" + to_string(rng() % 8) + "]";
+        for (int w = 0, total = 4 + rng() % 8; w < total; ++w) {
+            line += ' ';
+            line += words[rng() % wordCount];
+        }
+        line += '\n';
+        set.data.insert(set.data.end(), line.begin(), line.end());
+    }
+    set.data.resize(GENERATED_SIZE);
+    return set;
+}
+
+// Function to time the histogram, tree build, encode and decode phases of
+// the Huffman coder separately, keeping the fastest of `reps` runs of each
+static Measurement benchHuffman(const Dataset& set, size_t blockSize, int reps) {
+    Measurement result;
+    result.rawSize = set.data.size();
+
+    size_t blocks = (set.data.size() + blockSize - 1) / blockSize;
+    vector<array<uint64_t, ALPHABET_SIZE>> freqs(blocks);
+    vector<array<uint8_t, ALPHABET_SIZE>> lengths(blocks);
+    vector<CodeTable> codes(blocks);
+    vector<DecodeTable> tables(blocks);
+    vector<vector<uint8_t>> packed(blocks);
+    vector<uint8_t> decoded(set.data.size());
+
+    double histogram = 1e30, tree = 1e30, encode = 1e30, decode = 1e30;
+    bool ok = true;
+    for (int rep = 0; rep < reps; ++rep) {
+        double start = now();
+        for (size_t b = 0; b < blocks; ++b) {
+            size_t size = min(blockSize, set.data.size() - b * blockSize);
+            freqs[b].fill(0);
+            addToHistogram(set.data.data() + b * blockSize, size, freqs[b].data());
+        }
+        double afterHistogram = now();
+
+        for (size_t b = 0; b < blocks; ++b) {
+            buildCodeLengths(freqs[b].data(), lengths[b].data());
+            generateCodes(lengths[b].data(), codes[b]);
+            buildDecodeTable(lengths[b].data(), tables[b]);
+        }
+        double afterTree = now();
+
+        for (size_t b = 0; b < blocks; ++b) {
+            size_t size = min(blockSize, set.data.size() - b * blockSize);
+            packed[b].clear();
+            encodeText(set.data.data() + b * blockSize, size, codes[b], packed[b]);
+        }
+        double afterEncode = now();
+
+        for (size_t b = 0; b < blocks; ++b) {
+            size_t size = min(blockSize, set.data.size() - b * blockSize);
+            ok &= decodeText(packed[b].data(), packed[b].size(), tables[b], decoded.data() + b * blockSize, size);
+        }
+        double afterDecode = now();
+
+        histogram = min(histogram, afterHistogram - start);
+        tree = min(tree, afterTree - afterHistogram);
+        encode = min(encode, afterEncode - afterTree);
+        decode = min(decode, afterDecode - afterEncode);
+    }
+
+    for (const vector<uint8_t>& block : packed) result.packedSize += PACKED_LENGTHS_SIZE + block.size();
+    result.histogramMBps = mbps(set.data.size(), histogram);
+    result.treeMBps = mbps(set.data.size(), tree);
+    result.encodeMBps = mbps(set.data.size(), encode);
+    result.decodeMBps = mbps(set.data.size(), decode);
+    result.roundTrip = ok && decoded == set.data;
+    result.peakRssKiB = peakRssKiB();
+    return result;
+}
+
+// Function to time a coder that builds its tables inside encode(), so only
+// the encode and decode phases are reported. `encodeBlock` appends one
+// block's payload; `decodeBlock` decodes it.
+template <typename Encode, typename Decode>
+static Measurement benchCoder(const Dataset& set, size_t blockSize, int reps, Encode encodeBlock,
+                              Decode decodeBlock) {
+    Measurement result;
+    result.rawSize = set.data.size();
+
+    size_t blocks = (set.data.size() + blockSize - 1) / blockSize;
+    vector<vector<uint8_t>> packed(blocks);
+    vector<uint8_t> decoded(set.data.size());
+
+    double encode = 1e30, decode = 1e30;
+    bool ok = true;
+    for (int rep = 0; rep < reps; ++rep) {
+        double start = now();
+        for (size_t b = 0; b < blocks; ++b) {
+            size_t size = min(blockSize, set.data.size() - b * blockSize);
+            packed[b].clear();
+            encodeBlock(set.data.data() + b * blockSize, size, packed[b]);
+        }
+        double afterEncode = now();
+
+        for (size_t b = 0; b < blocks; ++b) {
+            size_t size = min(blockSize, set.data.size() - b * blockSize);
+            ok &= decodeBlock(packed[b].data(), packed[b].size(), decoded.data() + b * blockSize, size);
+        }
+        double afterDecode = now();
+
+        encode = min(encode, afterEncode - start);
+        decode = min(decode, afterDecode - afterEncode);
+    }
+
+    for (const vector<uint8_t>& block : packed) result.packedSize += block.size();
+    result.encodeMBps = mbps(set.data.size(), encode);
+    result.decodeMBps = mbps(set.data.size(), decode);
+    result.roundTrip = ok && decoded == set.data;
+    result.peakRssKiB = peakRssKiB();
+    return result;
+}
+
+// Function to load or generate `spec` and benchmark `coder` on it; an
+// empty data set leaves `result` with a raw size of 0
+static bool runCoder(const DatasetSpec& spec, const string& coder, size_t blockSize, int reps, int level,
+                     Measurement& result) {
+    Dataset set;
+    if (spec.generate != nullptr) {
+        set = spec.generate();
+    } else if (!loadFile(spec.name, set.data)) {
+        cerr << "Error opening file: " << spec.name << endl;
+        return false;
+    }
+    if (set.data.empty()) return true;
+
+    if (coder == "huffman") {
+        result = benchHuffman(set, blockSize, reps);
+    } else if (coder == "ans") {
+        AnsCoder ans;
+        result = benchCoder(set, blockSize, reps,
+            [&](const uint8_t* in, size_t size, vector<uint8_t>& out) {
+                uint64_t freq[ALPHABET_SIZE] = {};
+                addToHistogram(in, size, freq);
+                ans.encode(in, size, freq, out);
+            },
+            [&](const uint8_t* in, size_t size, uint8_t* out, size_t originalSize) {
+                return ans.decode(in, size, out, originalSize);
+            });
+    } else {
+        Lz77Coder lz(level);
+        result = benchCoder(set, blockSize, reps,
+            [&](const uint8_t* in, size_t size, vector<uint8_t>& out) { lz.encode(in, size, out); },
+            [&](const uint8_t* in, size_t size, uint8_t* out, size_t originalSize) {
+                return lz.decode(in, size, out, originalSize);
+            });
+    }
+    return true;
+}
+
+// Function to run one data set and coder in a fresh child process, so the
+// peak RSS it reports is not what earlier runs left behind; false if the
+// run failed or the child could not be started
+static bool measure(const DatasetSpec& spec, const string& coder, size_t blockSize, int reps, int level,
+                    Measurement& result) {
+#ifndef _WIN32
+    int channel[2];
+    if (pipe(channel) != 0) return false;
+    cout.flush();
+    cerr.flush();
+    pid_t child = fork();
+    if (child < 0) {
+        close(channel[0]);
+        close(channel[1]);
+        return false;
+    }
+    if (child == 0) {
+        close(channel[0]);
+        Measurement measured;
+        bool ok = runCoder(spec, coder, blockSize, reps, level, measured);
+        bool sent = write(channel[1], &measured, sizeof(measured)) == static_cast<ssize_t>(sizeof(measured));
+        _exit(ok && sent ? 0 : 1);
+    }
+
+    close(channel[1]);
+    size_t received = 0;
+    char* buffer = reinterpret_cast<char*>(&result);
+    while (received < sizeof(result)) {
+        ssize_t n = read(channel[0], buffer + received, sizeof(result) - received);
+        if (n <= 0) break;
+        received += n;
+    }
+    close(channel[0]);
+    int status = 0;
+    waitpid(child, &status, 0);
+    return received == sizeof(result) && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+#else
+    return runCoder(spec, coder, blockSize, reps, level, result);
+#endif
+}
+
+static string number(double value) {
+    if (value < 0) return "";
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.2f", value);
+    return buffer;
+}
+
+static void printCsv(const vector<Result>& results) {
+    cout << "dataset,coder,raw_bytes,packed_bytes,ratio,histogram_mbps,tree_mbps,encode_mbps,decode_mbps,"
+            "round_trip,peak_rss_kib" << endl;
+    for (const Result& r : results) {
+        double ratio = r.packedSize > 0 ? static_cast<double>(r.rawSize) / r.packedSize : 0;
+        cout << r.dataset << ',' << r.coder << ',' << r.rawSize << ',' << r.packedSize << ','
+             << number(ratio) << ',' << number(r.histogramMBps) << ',' << number(r.treeMBps) << ','
+             << number(r.encodeMBps) << ',' << number(r.decodeMBps) << ','
+             << (r.roundTrip ? "ok" : "FAIL") << ',' << r.peakRssKiB << endl;
+    }
+}
+
+static string jsonNumber(double value) {
+    return value < 0 ? "null" : number(value);
+}
+
+static string jsonString(const string& text) {
+    string quoted = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') quoted += '\\';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+static void printJson(const vector<Result>& results) {
+    cout << "[" << endl;
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        double ratio = r.packedSize > 0 ? static_cast<double>(r.rawSize) / r.packedSize : 0;
+        cout << "  {\"dataset\": " << jsonString(r.dataset) << ", \"coder\": " << jsonString(r.coder)
+             << ", \"raw_bytes\": " << r.rawSize << ", \"packed_bytes\": " << r.packedSize
+             << ", \"ratio\": " << number(ratio)
+             << ", \"histogram_mbps\": " << jsonNumber(r.histogramMBps)
+             << ", \"tree_mbps\": " << jsonNumber(r.treeMBps)
+             << ", \"encode_mbps\": " << jsonNumber(r.encodeMBps)
+             << ", \"decode_mbps\": " << jsonNumber(r.decodeMBps)
+             << ", \"round_trip\": " << (r.roundTrip ? "true" : "false")
+             << ", \"peak_rss_kib\": " << r.peakRssKiB << "}" << (i + 1 < results.size() ? "," : "") << endl;
+    }
+    cout << "]" << endl;
+}
+
+static void printUsage(const char* program) {
+    cerr << "Usage: " << program << " [options] [corpus files...]" << endl;
+    cerr << "Options:" << endl;
+    cerr << "  -f <csv|json>  output format (default: csv)" << endl;
+    cerr << "  -r <reps>      repetitions per phase, fastest is kept (default: 3)" << endl;
+    cerr << "  -b <KiB>       block size in KiB (default: 1024)" << endl;
+    cerr << "  -l <level>     LZ77 level to benchmark, 0 to skip (default: 6)" << endl;
+    cerr << "  -n             skip the generated random, skewed and text data sets" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    bool json = false;
+    int reps = 3;
+    size_t blockSize = DEFAULT_BLOCK_SIZE;
+    int level = 6;
+    bool generated = true;
+    vector<string> files;
+
+    for (int arg = 1; arg < argc; ++arg) {
+        string flag = argv[arg];
+        if (flag == "-f" && arg + 1 < argc) {
+            string format = argv[++arg];
+            if (format != "csv" && format != "json") {
+                printUsage(argv[0]);
+                return 1;
+            }
+            json = format == "json";
+        } else if (flag == "-r" && arg + 1 < argc) {
+            reps = max(1, atoi(argv[++arg]));
+        } else if (flag == "-b" && arg + 1 < argc) {
+            blockSize = static_cast<size_t>(max(1, atoi(argv[++arg]))) * 1024;
+        } else if (flag == "-l" && arg + 1 < argc) {
+            level = atoi(argv[++arg]);
+        } else if (flag == "-n") {
+            generated = false;
+        } else if (!flag.empty() && flag[0] == '-') {
+            printUsage(argv[0]);
+            return 1;
+        } else {
+            files.push_back(flag);
+        }
+    }
+
+    vector<DatasetSpec> specs;
+    if (generated) {
+        specs.push_back({ "random", randomData });
+        specs.push_back({ "skewed", skewedData });
+        specs.push_back({ "text", textData });
+    }
+    for (const string& name : files) {
+        if (!ifstream(name, ios::binary)) {
+            cerr << "Error opening file: " << name << endl;
+            return 1;
+        }
+        specs.push_back({ name, nullptr });
+    }
+
+    vector<string> coders = { "huffman", "ans" };
+    if (level > 0) coders.push_back("lz77-" + to_string(min(level, MAX_LEVEL)));
+
+    vector<Result> results;
+    bool ok = true;
+    for (const DatasetSpec& spec : specs) {
+        for (const string& coder : coders) {
+            Result result;
+            if (!measure(spec, coder, blockSize, reps, level, result)) {
+                cerr << "Run of " << coder << " on " << spec.name << " failed" << endl;
+                ok = false;
+                continue;
+            }
+            // Empty data sets have nothing to report
+            if (result.rawSize == 0) break;
+            result.dataset = spec.name;
+            result.coder = coder;
+            results.push_back(result);
+        }
+    }
+
+    for (const Result& r : results) ok &= r.roundTrip;
+    if (json) {
+        printJson(results);
+    } else {
+        printCsv(results);
+    }
+    return ok ? 0 : 1;
+}
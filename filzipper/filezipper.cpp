@@ -1,138 +1,79 @@
 #include <iostream>
-#include <fstream>
-#include <vector>
-#include <queue>
-#include <map>
+#include <string>
+#include <cstdlib>
+#include "Container.h"
 using namespace std;
 
-// Node structure for Huffman tree
-struct Node {
-    char character;
-    int freq;
-    Node *left, *right;
-
-    Node(char c, int f) : character(c), freq(f), left(nullptr), right(nullptr) {}
-};
-
-// Comparison function for priority queue
-struct Compare {
-    bool operator()(Node* left, Node* right) {
-        return left->freq > right->freq;
-    }
-};
-
-// Function to build Huffman tree
-Node* buildHuffmanTree(char data[], int freq[], int size) {
-    priority_queue<Node*, vector<Node*>, Compare> minHeap;
-
-    for (int i = 0; i < size; ++i) {
-        minHeap.push(new Node(data[i], freq[i]));
-    }
-
-    while (minHeap.size() > 1) {
-        Node* left = minHeap.top(); minHeap.pop();
-        Node* right = minHeap.top(); minHeap.pop();
-
-        Node* top = new Node('$', left->freq + right->freq);
-        top->left = left;
-        top->right = right;
-        minHeap.push(top);
-    }
-
-    return minHeap.top();
+void printUsage(const char* program) {
+    cerr << "Usage: " << program << " [options] -c <input> <output>   compress" << endl;
+    cerr << "       " << program << " [options] -d <input> <output>   decompress" << endl;
+    cerr << "       " << program << " -x <input> <offset> <length> <output>   extract a byte range" << endl;
+    cerr << "Options:" << endl;
+    cerr << "  -t <threads>   worker threads (default: all cores)" << endl;
+    cerr << "  -b <KiB>       chunk size in KiB, 1 to " << MAX_BLOCK_SIZE / 1024 << " (default: 1024)" << endl;
+    cerr << "  -g             use one shared Huffman table for the whole file" << endl;
+    cerr << "  -e <coder>     entropy coder: auto, huffman or ans (default: auto)" << endl;
+    cerr << "  -1 .. -9       find LZ77 matches before coding, -1 fastest, -9 smallest" << endl;
+    cerr << "Use - as <input> or <output> for stdin or stdout." << endl;
 }
 
-// Function to generate Huffman codes and store them in a map
-void generateCodes(Node* root, string code, map<char, string>& codes) {
-    if (root == nullptr) return;
+int main(int argc, char* argv[]) {
+    CompressOptions options;
 
-    if (!root->left && !root->right) {
-        codes[root->character] = code;
+    // With no arguments compress input.txt and decompress it again
+    if (argc == 1) {
+        if (!compressFile("input.txt", "compressed.txt", options)) return 1;
+        if (!decompressFile("compressed.txt", "decompressed.txt", options.threads)) return 1;
+        return 0;
     }
 
-    generateCodes(root->left, code + "0", codes);
-    generateCodes(root->right, code + "1", codes);
-}
-
-// Function to encode input text using Huffman codes
-void encodeText(ifstream& inFile, ofstream& outFile, map<char, string>& codes) {
-    char ch;
-    string encodedText = "";
-
-    while (inFile.get(ch)) {
-        encodedText += codes[ch];
+    int arg = 1;
+    while (arg < argc) {
+        string flag = argv[arg];
+        if (flag == "-t" && arg + 1 < argc) {
+            int threads = atoi(argv[arg + 1]);
+            if (threads < 0) break;
+            options.threads = threads;
+            arg += 2;
+        } else if (flag == "-b" && arg + 1 < argc) {
+            // Range-check the KiB count before scaling it, so no value wraps
+            const char* text = argv[arg + 1];
+            char* end = nullptr;
+            unsigned long kib = strtoul(text, &end, 10);
+            if (*text < '0' || *text > '9' || *end != '\0' || kib == 0 || kib > MAX_BLOCK_SIZE / 1024) break;
+            options.blockSize = static_cast<uint32_t>(kib) * 1024;
+            arg += 2;
+        } else if (flag == "-g") {
+            options.sharedTable = true;
+            arg++;
+        } else if (flag == "-e" && arg + 1 < argc) {
+            string coder = argv[arg + 1];
+            if (coder == "auto") options.coder = CODER_AUTO;
+            else if (coder == "huffman") options.coder = CODER_HUFFMAN;
+            else if (coder == "ans") options.coder = CODER_ANS;
+            else break;
+            arg += 2;
+        } else if (flag.size() == 2 && flag[0] == '-' && flag[1] >= '1' && flag[1] <= '9') {
+            options.level = flag[1] - '0';
+            arg++;
+        } else {
+            break;
+        }
     }
 
-    int padding = 8 - (encodedText.length() % 8);
-    encodedText.append(padding, '0'); // Adding padding bits
-
-    for (int i = 0; i < encodedText.length(); i += 8) {
-        string byte = encodedText.substr(i, 8);
-        char c = static_cast<char>(stoi(byte, nullptr, 2));
-        outFile.put(c);
+    int rest = argc - arg;
+    if (rest == 3 && string(argv[arg]) == "-c") {
+        return compressFile(argv[arg + 1], argv[arg + 2], options) ? 0 : 1;
     }
-}
-
-// Function to decode Huffman encoded text
-void decodeText(ifstream& inFile, ofstream& outFile, Node* root, int originalSize) {
-    Node* current = root;
-    char bit;
-    int decodedSize = 0;
-
-    while (decodedSize < originalSize) {
-        inFile.get(bit);
-
-        for (int i = 7; i >= 0; --i) {
-            int b = (bit >> i) & 1;
-
-            if (b == 0) current = current->left;
-            else current = current->right;
-
-            if (current->left == nullptr && current->right == nullptr) {
-                outFile.put(current->character);
-                current = root;
-                decodedSize++;
-                if (decodedSize == originalSize) break;
-            }
-        }
+    if (rest == 3 && string(argv[arg]) == "-d") {
+        return decompressFile(argv[arg + 1], argv[arg + 2], options.threads) ? 0 : 1;
+    }
+    if (rest == 5 && string(argv[arg]) == "-x") {
+        uint64_t offset = strtoull(argv[arg + 2], nullptr, 10);
+        uint64_t length = strtoull(argv[arg + 3], nullptr, 10);
+        return extractRange(argv[arg + 1], offset, length, argv[arg + 4]) ? 0 : 1;
     }
-}
-
-int main() {
-    // Example input frequencies and data
-    char data[] = { 'a', 'b', 'c', 'd', 'e', 'f' };
-    int freq[] = { 5, 9, 12, 13, 16, 45 };
-    int size = sizeof(data) / sizeof(data[0]);
-
-    // Build Huffman tree
-    Node* root = buildHuffmanTree(data, freq, size);
-
-    // Generate Huffman codes
-    map<char, string> codes;
-    generateCodes(root, "", codes);
-
-    // Open input and output files
-    ifstream inFile("input.txt");
-    ofstream compressedFile("compressed.txt", ios::binary);
-
-    // Encode input file
-    encodeText(inFile, compressedFile, codes);
-
-    // Close input and output files
-    inFile.close();
-    compressedFile.close();
-
-    // Open compressed file for decompression
-    ifstream compressedInput("compressed.txt", ios::binary);
-    ofstream decompressedOutput("decompressed.txt");
-
-    // Decode compressed file
-    decodeText(compressedInput, decompressedOutput, root, 100); // Assuming original file size is 100 characters
-
-    // Close decompressed file
-    compressedInput.close();
-    decompressedOutput.close();
 
-    return 0;
+    printUsage(argv[0]);
+    return 1;
 }
-
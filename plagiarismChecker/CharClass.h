@@ -0,0 +1,287 @@
+#ifndef CHARCLASS_H
+#define CHARCLASS_H
+
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using namespace std;
+
+// How the tokenizer treats a character: letters and digits make up words,
+// whitespace separates them and anything else is dropped without splitting
+// the word ("don't" -> "dont")
+enum CharClass : uint8_t {
+    CHAR_DROP,
+    CHAR_SPACE,
+    CHAR_WORD
+};
+
+// Class and lowercase form of every byte, independent of the locale. Bytes
+// from 0x80 up are only parts of UTF-8 sequences and are decoded instead.
+struct CharTable {
+    uint8_t cls[256];
+    char lower[256];
+
+    CharTable() {
+        for (int c = 0; c < 256; ++c) {
+            bool digit = c >= '0' && c <= '9';
+            bool upper = c >= 'A' && c <= 'Z';
+            bool letter = upper || (c >= 'a' && c <= 'z');
+            bool space = c == ' ' || (c >= '\t' && c <= '\r');
+            cls[c] = letter || digit ? CHAR_WORD : space ? CHAR_SPACE : CHAR_DROP;
+            lower[c] = static_cast<char>(upper ? c - 'A' + 'a' : c);
+        }
+    }
+};
+
+inline const CharTable& charTable() {
+    static const CharTable table;
+    return table;
+}
+
+const uint32_t INVALID_CODEPOINT = 0xFFFFFFFFu;
+
+// Function to decode the UTF-8 sequence at the start of n bytes into `cp`.
+// Returns its length, or 0 when the bytes end partway through a valid
+// sequence. An invalid byte (stray continuation, overlong form, surrogate)
+// comes back as INVALID_CODEPOINT with length 1, so it is skipped alone.
+inline size_t decodeUtf8(const uint8_t* p, size_t n, uint32_t& cp) {
+    uint8_t lead = p[0];
+    size_t length;
+    uint8_t low = 0x80, high = 0xBF; // range of the second byte
+    if (lead < 0x80) {
+        cp = lead;
+        return 1;
+    } else if (lead >= 0xC2 && lead <= 0xDF) {
+        length = 2;
+        cp = lead & 0x1F;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        length = 3;
+        cp = lead & 0x0F;
+        if (lead == 0xE0) low = 0xA0;
+        if (lead == 0xED) high = 0x9F;
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        length = 4;
+        cp = lead & 0x07;
+        if (lead == 0xF0) low = 0x90;
+        if (lead == 0xF4) high = 0x8F;
+    } else {
+        cp = INVALID_CODEPOINT;
+        return 1;
+    }
+
+    for (size_t k = 1; k < length; ++k) {
+        if (k == n) return 0;
+        uint8_t next = p[k];
+        if (next < (k == 1 ? low : 0x80) || next > (k == 1 ? high : 0xBF)) {
+            cp = INVALID_CODEPOINT;
+            return 1;
+        }
+        cp = cp << 6 | (next & 0x3F);
+    }
+    return length;
+}
+
+inline void appendUtf8(string& out, uint32_t cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | cp >> 6);
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | cp >> 12);
+        out += static_cast<char>(0x80 | (cp >> 6 & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | cp >> 18);
+        out += static_cast<char>(0x80 | (cp >> 12 & 0x3F));
+        out += static_cast<char>(0x80 | (cp >> 6 & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+// Function to classify a code point from 0x80 up and give its lowercase
+// form. Unicode spaces separate words, and Latin-1 symbols, general
+// punctuation, symbols and emoji are dropped like ASCII punctuation
+// ("don’t" -> "dont"). Everything else is a word character; Latin-1,
+// Latin Extended-A, Greek and Cyrillic capitals are lowercased, and other
+// scripts are kept as they are.
+inline CharClass classifyCodepoint(uint32_t cp, uint32_t& lower) {
+    lower = cp;
+    if (cp == 0x85 || cp == 0xA0 || cp == 0x1680 || (cp >= 0x2000 && cp <= 0x200A) || cp == 0x2028
+        || cp == 0x2029 || cp == 0x202F || cp == 0x205F || cp == 0x3000) {
+        return CHAR_SPACE;
+    }
+    if (cp < 0xC0) return cp == 0xAA || cp == 0xB5 || cp == 0xBA ? CHAR_WORD : CHAR_DROP;
+    if (cp == 0xD7 || cp == 0xF7 || (cp >= 0x2000 && cp <= 0x2BFF) || (cp >= 0x3001 && cp <= 0x303F)
+        || cp == 0xFEFF || (cp >= 0x1F000 && cp <= 0x1FAFF)) {
+        return CHAR_DROP;
+    }
+
+    if (cp <= 0xDE) {
+        lower = cp + 0x20;
+    } else if (cp >= 0x100 && cp <= 0x17F) {
+        // Capitals and small letters alternate, in two runs starting with
+        // an odd capital, and a few letters have no pair here
+        bool oddRun = (cp >= 0x139 && cp <= 0x148) || (cp >= 0x179 && cp <= 0x17E);
+        if (cp == 0x130) {
+            lower = 'i';
+        } else if (cp == 0x178) {
+            lower = 0xFF;
+        } else if (cp != 0x131 && cp != 0x138 && cp != 0x149 && cp != 0x17F && cp % 2 == (oddRun ? 1u : 0u)) {
+            lower = cp + 1;
+        }
+    } else if (cp == 0x386) {
+        lower = 0x3AC;
+    } else if (cp >= 0x388 && cp <= 0x38A) {
+        lower = cp + 0x25;
+    } else if (cp == 0x38C) {
+        lower = 0x3CC;
+    } else if (cp == 0x38E || cp == 0x38F) {
+        lower = cp + 0x3F;
+    } else if (cp >= 0x391 && cp <= 0x3AB && cp != 0x3A2) {
+        lower = cp + 0x20;
+    } else if (cp >= 0x400 && cp <= 0x40F) {
+        lower = cp + 0x50;
+    } else if (cp >= 0x410 && cp <= 0x42F) {
+        lower = cp + 0x20;
+    }
+    return CHAR_WORD;
+}
+
+// Bit k describes byte k of a 64-byte block of text
+struct ByteMasks {
+    uint64_t start; // can begin a word: an ASCII letter or digit, or a non-ASCII byte
+    uint64_t clean; // already normalized: a-z or 0-9
+};
+
+inline int countTrailingZeros(uint64_t bits) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+// Function to classify 64 bytes at once: with AVX2 32 and with SSE2 or
+// NEON 16 per step, in a handful of compares against the ranges a-z, A-Z
+// and 0-9. Define TOKENIZER_SCALAR to use the byte table instead.
+inline ByteMasks classifyBlock(const uint8_t* p) {
+    ByteMasks masks = { 0, 0 };
+#if !defined(TOKENIZER_SCALAR) && defined(__AVX2__)
+    // Unsigned x - lo <= hi - lo, as min(x - lo, hi - lo) == x - lo
+    auto inRange = [](__m256i x, char lo, char hi) {
+        __m256i shifted = _mm256_sub_epi8(x, _mm256_set1_epi8(lo));
+        return _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8(static_cast<char>(hi - lo))), shifted);
+    };
+    for (int k = 0; k < 64; k += 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + k));
+        __m256i clean = _mm256_or_si256(inRange(x, 'a', 'z'), inRange(x, '0', '9'));
+        // Bytes from 0x80 up have their top bit set already
+        __m256i start = _mm256_or_si256(_mm256_or_si256(clean, inRange(x, 'A', 'Z')), x);
+        masks.clean |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(clean))) << k;
+        masks.start |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(start))) << k;
+    }
+#elif !defined(TOKENIZER_SCALAR) && (defined(__SSE2__) || defined(_M_X64))
+    auto inRange = [](__m128i x, char lo, char hi) {
+        __m128i shifted = _mm_sub_epi8(x, _mm_set1_epi8(lo));
+        return _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8(static_cast<char>(hi - lo))), shifted);
+    };
+    for (int k = 0; k < 64; k += 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + k));
+        __m128i clean = _mm_or_si128(inRange(x, 'a', 'z'), inRange(x, '0', '9'));
+        __m128i start = _mm_or_si128(_mm_or_si128(clean, inRange(x, 'A', 'Z')), x);
+        masks.clean |= static_cast<uint64_t>(_mm_movemask_epi8(clean)) << k;
+        masks.start |= static_cast<uint64_t>(_mm_movemask_epi8(start)) << k;
+    }
+#elif !defined(TOKENIZER_SCALAR) && (defined(__aarch64__) || defined(_M_ARM64))
+    auto inRange = [](uint8x16_t x, uint8_t lo, uint8_t hi) {
+        return vcleq_u8(vsubq_u8(x, vdupq_n_u8(lo)), vdupq_n_u8(hi - lo));
+    };
+    // NEON has no movemask: weight each lane by its bit and add up each half
+    static const uint8_t weights[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+    auto toBits = [](uint8x16_t lanes) {
+        uint8x16_t bits = vandq_u8(lanes, vld1q_u8(weights));
+        return static_cast<uint64_t>(vaddv_u8(vget_low_u8(bits))) | static_cast<uint64_t>(vaddv_u8(vget_high_u8(bits))) << 8;
+    };
+    for (int k = 0; k < 64; k += 16) {
+        uint8x16_t x = vld1q_u8(p + k);
+        uint8x16_t clean = vorrq_u8(inRange(x, 'a', 'z'), inRange(x, '0', '9'));
+        uint8x16_t start = vorrq_u8(vorrq_u8(clean, inRange(x, 'A', 'Z')), vcgeq_u8(x, vdupq_n_u8(0x80)));
+        masks.clean |= toBits(clean) << k;
+        masks.start |= toBits(start) << k;
+    }
+#else
+    const CharTable& table = charTable();
+    for (int k = 0; k < 64; ++k) {
+        uint8_t c = p[k];
+        bool word = table.cls[c] == CHAR_WORD;
+        masks.start |= static_cast<uint64_t>(word || c >= 0x80) << k;
+        masks.clean |= static_cast<uint64_t>(word && table.lower[c] == static_cast<char>(c)) << k;
+    }
+#endif
+    return masks;
+}
+
+// Finds the next byte of a kind in a block of text, classifying it 64
+// bytes at a time and keeping the masks of the current 64 bytes. The last
+// partial 64 bytes are classified from a zero-padded copy; zero bytes
+// belong to neither mask.
+class ByteScanner {
+public:
+    ByteScanner(const uint8_t* data, size_t n) : data(data), n(n) {}
+
+    // Function to return the first position from i that can begin a word,
+    // or n if there is none
+    size_t nextStart(size_t i) { return next(i, false); }
+
+    // Function to return the first position from i that is not a-z or 0-9
+    // (a space, punctuation, capital or non-ASCII byte), or n
+    size_t nextUnclean(size_t i) { return next(i, true); }
+
+private:
+    size_t next(size_t i, bool unclean) {
+        while (i < n) {
+            size_t block = i & ~static_cast<size_t>(63);
+            if (block != loaded) load(block);
+            uint64_t bits = (unclean ? ~masks.clean : masks.start) >> (i & 63);
+            if (bits != 0) {
+                size_t found = i + countTrailingZeros(bits);
+                return found < n ? found : n;
+            }
+            i = block + 64;
+        }
+        return n;
+    }
+
+    void load(size_t block) {
+        if (block + 64 <= n) {
+            masks = classifyBlock(data + block);
+        } else {
+            uint8_t tail[64] = {};
+            memcpy(tail, data + block, n - block);
+            masks = classifyBlock(tail);
+        }
+        loaded = block;
+    }
+
+    const uint8_t* data;
+    size_t n;
+    size_t loaded = SIZE_MAX;
+    ByteMasks masks = { 0, 0 };
+};
+
+#endif
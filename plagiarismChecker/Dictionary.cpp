@@ -0,0 +1,158 @@
+#include "Dictionary.h"
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+
+const char DICTIONARY_MAGIC[4] = { 'D', 'I', 'C', '1' };
+
+// Arena block size; longer words get a block of their own
+const size_t ARENA_BLOCK_SIZE = 1 << 16;
+
+// FNV-1a, folded so the low bits used for the slot depend on every byte
+uint64_t hashWord(string_view word) {
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : word) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash ^ (hash >> 32);
+}
+
+string_view Dictionary::store(string_view word) {
+    if (blocks.empty() || blockUsed + word.size() > blockSize) {
+        blockSize = max(ARENA_BLOCK_SIZE, word.size());
+        blocks.emplace_back(new char[blockSize]);
+        blockUsed = 0;
+    }
+    char* dst = blocks.back().get() + blockUsed;
+    memcpy(dst, word.data(), word.size());
+    blockUsed += word.size();
+    return string_view(dst, word.size());
+}
+
+// Function to find the slot holding word, or the empty slot where it belongs
+size_t Dictionary::slotOf(string_view word, uint64_t hash) const {
+    size_t mask = slots.size() - 1;
+    for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+        uint32_t entry = slots[slot];
+        if (entry == 0) return slot;
+        if (hashes[entry - 1] == hash && words[entry - 1] == word) return slot;
+    }
+}
+
+// Function to double the table, keeping it at most half full
+void Dictionary::grow() {
+    slots.assign(max<size_t>(1024, slots.size() * 2), 0);
+    size_t mask = slots.size() - 1;
+    for (uint32_t id = 0; id < words.size(); ++id) {
+        size_t slot = hashes[id] & mask;
+        while (slots[slot] != 0) slot = (slot + 1) & mask;
+        slots[slot] = id + 1;
+    }
+}
+
+uint32_t Dictionary::intern(string_view word) {
+    if (2 * (words.size() + 1) > slots.size()) grow();
+
+    uint64_t hash = hashWord(word);
+    size_t slot = slotOf(word, hash);
+    if (slots[slot] != 0) return slots[slot] - 1;
+
+    uint32_t id = words.size();
+    words.push_back(store(word));
+    hashes.push_back(hash);
+    slots[slot] = id + 1;
+    return id;
+}
+
+uint32_t Dictionary::find(string_view word) const {
+    if (slots.empty()) return NOT_FOUND;
+    size_t slot = slotOf(word, hashWord(word));
+    return slots[slot] == 0 ? NOT_FOUND : slots[slot] - 1;
+}
+
+bool Dictionary::save(const string& filename) const {
+    FILE* file = fopen(filename.c_str(), "wb");
+    if (!file) {
+        cerr << "Error opening file: " << filename << endl;
+        return false;
+    }
+
+    uint32_t count = words.size();
+    uint64_t bytes = 0;
+    vector<uint32_t> lengths(count);
+    for (uint32_t id = 0; id < count; ++id) {
+        lengths[id] = words[id].size();
+        bytes += lengths[id];
+    }
+
+    bool ok = fwrite(DICTIONARY_MAGIC, 1, sizeof(DICTIONARY_MAGIC), file) == sizeof(DICTIONARY_MAGIC)
+        && fwrite(&count, sizeof(count), 1, file) == 1
+        && fwrite(&bytes, sizeof(bytes), 1, file) == 1
+        && fwrite(lengths.data(), sizeof(uint32_t), count, file) == count;
+    for (uint32_t id = 0; ok && id < count; ++id) {
+        ok = fwrite(words[id].data(), 1, words[id].size(), file) == words[id].size();
+    }
+    ok = fclose(file) == 0 && ok;
+
+    if (!ok) cerr << "Error writing file: " << filename << endl;
+    return ok;
+}
+
+bool Dictionary::load(const string& filename) {
+    FILE* file = fopen(filename.c_str(), "rb");
+    if (!file) {
+        cerr << "Error opening file: " << filename << endl;
+        return false;
+    }
+
+    char magic[4];
+    uint32_t count = 0;
+    uint64_t bytes = 0;
+    bool ok = fread(magic, 1, sizeof(magic), file) == sizeof(magic)
+        && memcmp(magic, DICTIONARY_MAGIC, sizeof(magic)) == 0
+        && fread(&count, sizeof(count), 1, file) == 1
+        && fread(&bytes, sizeof(bytes), 1, file) == 1
+        && count < NOT_FOUND;
+
+    // The lengths and text must fill the rest of the file exactly, so a
+    // corrupt header cannot make us allocate more than the file holds
+    long start = ok ? ftell(file) : -1;
+    ok = ok && start >= 0 && fseek(file, 0, SEEK_END) == 0;
+    long end = ok ? ftell(file) : -1;
+    ok = ok && end >= start && fseek(file, start, SEEK_SET) == 0;
+    if (ok) {
+        uint64_t rest = end - start;
+        ok = bytes <= rest && static_cast<uint64_t>(count) * sizeof(uint32_t) == rest - bytes;
+    }
+
+    vector<uint32_t> lengths;
+    vector<char> text;
+    if (ok) {
+        lengths.resize(count);
+        ok = fread(lengths.data(), sizeof(uint32_t), count, file) == count;
+        uint64_t total = 0;
+        for (uint32_t length : lengths) total += length;
+        ok = ok && total == bytes;
+    }
+    if (ok) {
+        text.resize(bytes);
+        ok = fread(text.data(), 1, bytes, file) == bytes;
+    }
+    fclose(file);
+
+    if (!ok) {
+        cerr << "Invalid dictionary file: " << filename << endl;
+        return false;
+    }
+
+    // Ids keep their order, so term vectors built with the saved
+    // dictionary stay valid
+    *this = Dictionary();
+    size_t offset = 0;
+    for (uint32_t length : lengths) {
+        intern(string_view(text.data() + offset, length));
+        offset += length;
+    }
+    return size() == count;
+}
@@ -0,0 +1,52 @@
+#ifndef DICTIONARY_H
+#define DICTIONARY_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+// Function to hash a word (FNV-1a); stable across runs and platforms
+uint64_t hashWord(string_view word);
+
+// String interner that gives every distinct word a dense id (0, 1, 2, ...),
+// so documents become arrays of integers. Word bytes live back to back in
+// large arena blocks that never move, so word(id) views stay valid for the
+// dictionary's lifetime; an open-addressing table of ids finds words with
+// one hash per lookup.
+//
+// File layout (native byte order):
+//   "DIC1" | u32 words | u64 bytes | u32 lengths[words] | word bytes
+class Dictionary {
+public:
+    static constexpr uint32_t NOT_FOUND = 0xFFFFFFFFu;
+
+    // Function to return the id of word, adding it if it is new
+    uint32_t intern(string_view word);
+    uint32_t find(string_view word) const;
+
+    string_view word(uint32_t id) const { return words[id]; }
+    size_t size() const { return words.size(); }
+
+    bool save(const string& filename) const;
+    bool load(const string& filename);
+
+private:
+    size_t slotOf(string_view word, uint64_t hash) const;
+    void grow();
+    string_view store(string_view word);
+
+    vector<unique_ptr<char[]>> blocks;
+    size_t blockUsed = 0;
+    size_t blockSize = 0;
+
+    vector<string_view> words;
+    vector<uint64_t> hashes;
+    vector<uint32_t> slots; // id + 1, 0 for an empty slot
+};
+
+#endif
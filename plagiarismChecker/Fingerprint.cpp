@@ -0,0 +1,150 @@
+#include "Fingerprint.h"
+#include "MinHash.h"
+#include <algorithm>
+#include <utility>
+
+// Rabin-Karp base; the k-gram hash is sum(word[i] * BASE^(K-1-i)) mod 2^64
+const uint64_t ROLLING_BASE = 0x100000001b3ull;
+
+static constexpr uint64_t power(uint64_t base, int exponent) {
+    return exponent == 0 ? 1 : base * power(base, exponent - 1);
+}
+
+const uint64_t ROLLING_BASE_K = power(ROLLING_BASE, WINNOW_K);
+
+void Winnower::add(uint64_t wordHash) {
+    uint64_t word = mix64(wordHash);
+    uint64_t& slot = words[count % WINNOW_K];
+
+    // Shift the new word in and, once the k-gram is full, the oldest out
+    rolling = rolling * ROLLING_BASE + word;
+    if (count >= WINNOW_K) rolling -= slot * ROLLING_BASE_K;
+    slot = word;
+    count++;
+
+    if (count >= WINNOW_K) push(mix64(rolling), count - WINNOW_K);
+}
+
+void Winnower::push(uint64_t hash, uint32_t position) {
+    if (queued > 0 && window[head].position + WINNOW_WINDOW <= position) {
+        head = (head + 1) % WINNOW_WINDOW;
+        queued--;
+    }
+    // A later k-gram with an equal or smaller hash takes over, so the head
+    // is the rightmost minimum
+    while (queued > 0 && window[(head + queued - 1) % WINNOW_WINDOW].hash >= hash) queued--;
+    window[(head + queued) % WINNOW_WINDOW] = { hash, position };
+    queued++;
+    if (position + 1 < WINNOW_WINDOW) return;
+
+    // Robust winnowing: the last pick stays while it is in the window and
+    // ties the minimum, so a run of repeated k-grams yields one fingerprint
+    // per window length rather than one per k-gram
+    bool keep = lastPicked >= 0 && lastPicked + WINNOW_WINDOW > position && lastPickedHash == window[head].hash;
+    if (!keep && window[head].position != lastPicked) {
+        picked.push_back(window[head]);
+        lastPicked = window[head].position;
+        lastPickedHash = window[head].hash;
+    }
+}
+
+void Winnower::finish(vector<Fingerprint>& out) {
+    // A document with fewer k-grams than one window keeps its smallest
+    if (queued > 0 && picked.empty()) picked.push_back(window[head]);
+
+    out = move(picked);
+    picked.clear();
+    rolling = 0;
+    count = 0;
+    head = 0;
+    queued = 0;
+    lastPicked = -1;
+}
+
+uint32_t FingerprintIndex::add(const string& name, FingerprintedDocument document) {
+    uint32_t id = names.size();
+    for (const Fingerprint& fingerprint : document.fingerprints) {
+        postings[fingerprint.hash].push_back({ id, fingerprint.position });
+    }
+    names.push_back(name);
+    documents.push_back(move(document));
+    return id;
+}
+
+void FingerprintIndex::matches(const FingerprintedDocument& query, vector<MatchRegion>& out) const {
+    out.clear();
+
+    struct Hit {
+        uint32_t document;
+        int64_t diagonal; // other position minus query position
+        uint32_t query;
+    };
+    vector<Hit> hits;
+    for (const Fingerprint& fingerprint : query.fingerprints) {
+        auto found = postings.find(fingerprint.hash);
+        if (found == postings.end()) continue;
+        for (const Posting& posting : found->second) {
+            hits.push_back({ posting.document, static_cast<int64_t>(posting.position) - fingerprint.position,
+                             fingerprint.position });
+        }
+    }
+    sort(hits.begin(), hits.end(), [](const Hit& a, const Hit& b) {
+        if (a.document != b.document) return a.document < b.document;
+        if (a.diagonal != b.diagonal) return a.diagonal < b.diagonal;
+        return a.query < b.query;
+    });
+
+    // Chain the hits along each diagonal
+    vector<MatchRegion> regions;
+    for (const Hit& hit : hits) {
+        uint32_t other = static_cast<uint32_t>(hit.query + hit.diagonal);
+        if (!regions.empty()) {
+            MatchRegion& last = regions.back();
+            if (last.document == hit.document && static_cast<int64_t>(last.otherFirst) - last.queryFirst == hit.diagonal
+                && hit.query <= last.queryEnd + WINNOW_WINDOW) {
+                last.queryEnd = max(last.queryEnd, hit.query + WINNOW_K);
+                last.otherEnd = max(last.otherEnd, other + WINNOW_K);
+                last.fingerprints++;
+                continue;
+            }
+        }
+        regions.push_back({ hit.document, hit.query, hit.query + WINNOW_K, other, other + WINNOW_K, 1 });
+    }
+
+    // Grow each chain to the whole run of equal words around it
+    for (MatchRegion& region : regions) {
+        const vector<uint64_t>& other = documents[region.document].words;
+        while (region.queryFirst > 0 && region.otherFirst > 0
+               && query.words[region.queryFirst - 1] == other[region.otherFirst - 1]) {
+            region.queryFirst--;
+            region.otherFirst--;
+        }
+        while (region.queryEnd < query.words.size() && region.otherEnd < other.size()
+               && query.words[region.queryEnd] == other[region.otherEnd]) {
+            region.queryEnd++;
+            region.otherEnd++;
+        }
+    }
+
+    // Join chains that an insertion or deletion shifted onto a neighbouring
+    // diagonal
+    sort(regions.begin(), regions.end(), [](const MatchRegion& a, const MatchRegion& b) {
+        if (a.document != b.document) return a.document < b.document;
+        return a.queryFirst < b.queryFirst;
+    });
+    for (const MatchRegion& region : regions) {
+        if (!out.empty()) {
+            MatchRegion& last = out.back();
+            if (last.document == region.document && region.queryFirst <= last.queryEnd + WINNOW_WINDOW
+                && region.otherFirst <= last.otherEnd + WINNOW_WINDOW
+                && region.otherEnd + WINNOW_WINDOW >= last.otherFirst) {
+                last.queryEnd = max(last.queryEnd, region.queryEnd);
+                last.otherFirst = min(last.otherFirst, region.otherFirst);
+                last.otherEnd = max(last.otherEnd, region.otherEnd);
+                last.fingerprints += region.fingerprints;
+                continue;
+            }
+        }
+        out.push_back(region);
+    }
+}
@@ -0,0 +1,106 @@
+#ifndef FINGERPRINT_H
+#define FINGERPRINT_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+// Winnowing (Schleimer, Wilkerson and Aiken): every run of WINNOW_K words is
+// hashed with a Rabin-Karp rolling hash, and of every WINNOW_WINDOW
+// consecutive k-gram hashes the smallest is kept as a fingerprint. Two
+// documents sharing a run of at least WINNOW_GUARANTEE words are certain to
+// share a fingerprint, while a document keeps only about 2 / (WINNOW_WINDOW
+// + 1) of its k-grams.
+const int WINNOW_K = 5;
+const int WINNOW_WINDOW = 4;
+const int WINNOW_GUARANTEE = WINNOW_K + WINNOW_WINDOW - 1;
+
+struct Fingerprint {
+    uint64_t hash;
+    uint32_t position; // index of the k-gram's first word
+};
+
+// Byte range [begin, end) of a word in its file
+struct WordSpan {
+    uint64_t begin;
+    uint64_t end;
+};
+
+// A document's fingerprints, in order, and the hash and place of each of
+// its words
+struct FingerprintedDocument {
+    vector<Fingerprint> fingerprints;
+    vector<uint64_t> words;
+    vector<WordSpan> spans;
+};
+
+// Selects fingerprints from a stream of word hashes (see hashWord) in
+// constant time per word
+class Winnower {
+public:
+    void add(uint64_t wordHash);
+
+    // Function to move the fingerprints so far into `out` and start over
+    void finish(vector<Fingerprint>& out);
+
+private:
+    void push(uint64_t hash, uint32_t position);
+
+    uint64_t words[WINNOW_K];
+    uint64_t rolling = 0;
+    uint32_t count = 0;
+
+    // Window candidates with increasing hashes, oldest first; never more
+    // than WINNOW_WINDOW of them
+    Fingerprint window[WINNOW_WINDOW];
+    int head = 0;
+    int queued = 0;
+    int64_t lastPicked = -1; // position of the last fingerprint recorded
+    uint64_t lastPickedHash = 0;
+    vector<Fingerprint> picked;
+};
+
+// A run of words shared by the query document and an indexed one, as word
+// index ranges [first, end) in each
+struct MatchRegion {
+    uint32_t document;
+    uint32_t queryFirst, queryEnd;
+    uint32_t otherFirst, otherEnd;
+    uint32_t fingerprints; // shared fingerprints inside the region
+};
+
+// Inverted index from fingerprint hash to the documents and positions it
+// occurs at. A query costs one lookup per fingerprint of the query document
+// plus its hits, independent of the corpus size.
+class FingerprintIndex {
+public:
+    uint32_t add(const string& name, FingerprintedDocument document);
+
+    // Function to find the regions `query` shares with indexed documents,
+    // sorted by document and then query position. Hits along one diagonal
+    // that are at most WINNOW_WINDOW words apart form one region, which is
+    // then grown word by word to the exact extent of the match. Regions
+    // within that gap in both documents are joined, so an edit or two
+    // inside a copied passage does not split it.
+    void matches(const FingerprintedDocument& query, vector<MatchRegion>& out) const;
+
+    size_t size() const { return names.size(); }
+    const string& name(uint32_t id) const { return names[id]; }
+    const FingerprintedDocument& document(uint32_t id) const { return documents[id]; }
+
+private:
+    struct Posting {
+        uint32_t document;
+        uint32_t position;
+    };
+
+    vector<string> names;
+    vector<FingerprintedDocument> documents;
+    unordered_map<uint64_t, vector<Posting>> postings;
+};
+
+#endif
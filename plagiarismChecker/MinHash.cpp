@@ -0,0 +1,173 @@
+#include "MinHash.h"
+#include <iostream>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+const char SIGNATURE_MAGIC[4] = { 'S', 'I', 'G', '1' };
+
+// Hash function i is (a[i] * x + b[i]) >> 32 over a well-mixed shingle hash
+// x: one multiply-add per function, with fixed seeds so signatures from
+// different runs compare
+struct HashFamily {
+    uint64_t a[MINHASH_SIZE];
+    uint64_t b[MINHASH_SIZE];
+
+    HashFamily() {
+        uint64_t seed = 0x5eed;
+        for (int i = 0; i < MINHASH_SIZE; ++i) {
+            a[i] = mix64(seed++) | 1;
+            b[i] = mix64(seed++);
+        }
+    }
+};
+
+static const HashFamily& hashFamily() {
+    static const HashFamily family;
+    return family;
+}
+
+MinHasher::MinHasher() {
+    fill(mins, mins + MINHASH_SIZE, 0xFFFFFFFFu);
+}
+
+void MinHasher::addShingle(uint64_t shingle) {
+    const HashFamily& family = hashFamily();
+    uint64_t x = mix64(shingle);
+    for (int i = 0; i < MINHASH_SIZE; ++i) {
+        uint32_t h = static_cast<uint32_t>((family.a[i] * x + family.b[i]) >> 32);
+        mins[i] = min(mins[i], h);
+    }
+}
+
+void MinHasher::add(uint64_t wordHash) {
+    window[words % SHINGLE_SIZE] = wordHash;
+    words++;
+    if (words < SHINGLE_SIZE) return;
+
+    // Combine the window oldest first, so a shingle is an ordered run
+    uint64_t shingle = 0;
+    for (size_t k = words - SHINGLE_SIZE; k < words; ++k) shingle = mix64(shingle ^ window[k % SHINGLE_SIZE]);
+    addShingle(shingle);
+}
+
+void MinHasher::finish(Signature& out) {
+    // A document shorter than one shingle is a single shorter shingle
+    if (words > 0 && words < SHINGLE_SIZE) {
+        uint64_t shingle = 0;
+        for (size_t k = 0; k < words; ++k) shingle = mix64(shingle ^ window[k]);
+        addShingle(shingle);
+    }
+
+    copy(mins, mins + MINHASH_SIZE, out.values);
+    fill(mins, mins + MINHASH_SIZE, 0xFFFFFFFFu);
+    words = 0;
+}
+
+double estimateJaccard(const Signature& a, const Signature& b) {
+    int equal = 0;
+    for (int i = 0; i < MINHASH_SIZE; ++i) equal += a.values[i] == b.values[i];
+    return static_cast<double>(equal) / MINHASH_SIZE;
+}
+
+uint64_t SignatureIndex::bandKey(const Signature& signature, int band) {
+    uint64_t key = mix64(band);
+    for (int r = 0; r < LSH_ROWS; ++r) key = mix64(key ^ signature.values[band * LSH_ROWS + r]);
+    return key;
+}
+
+uint32_t SignatureIndex::add(const string& name, const Signature& signature) {
+    auto existing = ids.find(name);
+    if (existing == ids.end()) {
+        uint32_t id = names.size();
+        ids.emplace(name, id);
+        names.push_back(name);
+        signatures.push_back(signature);
+        for (int band = 0; band < LSH_BANDS; ++band) buckets[bandKey(signature, band)].push_back(id);
+        return id;
+    }
+
+    uint32_t id = existing->second;
+    for (int band = 0; band < LSH_BANDS; ++band) {
+        vector<uint32_t>& bucket = buckets[bandKey(signatures[id], band)];
+        bucket.erase(remove(bucket.begin(), bucket.end(), id), bucket.end());
+    }
+    signatures[id] = signature;
+    for (int band = 0; band < LSH_BANDS; ++band) buckets[bandKey(signature, band)].push_back(id);
+    return id;
+}
+
+void SignatureIndex::candidates(const Signature& signature, vector<uint32_t>& out) const {
+    out.clear();
+    for (int band = 0; band < LSH_BANDS; ++band) {
+        auto bucket = buckets.find(bandKey(signature, band));
+        if (bucket != buckets.end()) out.insert(out.end(), bucket->second.begin(), bucket->second.end());
+    }
+    sort(out.begin(), out.end());
+    out.erase(unique(out.begin(), out.end()), out.end());
+}
+
+bool SignatureIndex::save(const string& filename) const {
+    FILE* file = fopen(filename.c_str(), "wb");
+    if (!file) {
+        cerr << "Error opening file: " << filename << endl;
+        return false;
+    }
+
+    uint32_t count = names.size();
+    uint32_t width = MINHASH_SIZE;
+    bool ok = fwrite(SIGNATURE_MAGIC, 1, sizeof(SIGNATURE_MAGIC), file) == sizeof(SIGNATURE_MAGIC)
+        && fwrite(&count, sizeof(count), 1, file) == 1
+        && fwrite(&width, sizeof(width), 1, file) == 1;
+    for (uint32_t id = 0; ok && id < count; ++id) {
+        uint32_t length = names[id].size();
+        ok = fwrite(&length, sizeof(length), 1, file) == 1
+            && fwrite(names[id].data(), 1, length, file) == length;
+    }
+    ok = ok && fwrite(signatures.data(), sizeof(Signature), count, file) == count;
+    ok = fclose(file) == 0 && ok;
+
+    if (!ok) cerr << "Error writing file: " << filename << endl;
+    return ok;
+}
+
+bool SignatureIndex::load(const string& filename) {
+    FILE* file = fopen(filename.c_str(), "rb");
+    if (!file) {
+        cerr << "Error opening file: " << filename << endl;
+        return false;
+    }
+
+    char magic[4];
+    uint32_t count = 0, width = 0;
+    bool ok = fread(magic, 1, sizeof(magic), file) == sizeof(magic)
+        && memcmp(magic, SIGNATURE_MAGIC, sizeof(magic)) == 0
+        && fread(&count, sizeof(count), 1, file) == 1
+        && fread(&width, sizeof(width), 1, file) == 1
+        && width == MINHASH_SIZE;
+
+    vector<string> loadedNames;
+    for (uint32_t id = 0; ok && id < count; ++id) {
+        uint32_t length;
+        ok = fread(&length, sizeof(length), 1, file) == 1 && length < (1u << 16);
+        if (!ok) break;
+        string name(length, '\0');
+        ok = fread(&name[0], 1, length, file) == length;
+        loadedNames.push_back(move(name));
+    }
+    vector<Signature> loadedSignatures(ok ? count : 0);
+    ok = ok && fread(loadedSignatures.data(), sizeof(Signature), count, file) == count;
+    fclose(file);
+
+    if (!ok) {
+        cerr << "Invalid signature index: " << filename << endl;
+        return false;
+    }
+
+    names.clear();
+    signatures.clear();
+    ids.clear();
+    buckets.clear();
+    for (uint32_t id = 0; id < count; ++id) add(loadedNames[id], loadedSignatures[id]);
+    return true;
+}
@@ -0,0 +1,93 @@
+#ifndef MINHASH_H
+#define MINHASH_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+// Documents are sets of shingles: runs of SHINGLE_SIZE consecutive words.
+// A MinHash signature keeps, for each of MINHASH_SIZE hash functions, the
+// smallest hash over the document's shingles; the share of equal entries in
+// two signatures estimates the Jaccard similarity of their shingle sets.
+const int SHINGLE_SIZE = 3;
+const int MINHASH_SIZE = 128;
+
+// LSH banding: two documents become candidates when all LSH_ROWS values of
+// any one of LSH_BANDS bands agree. With 32 bands of 4 rows a pair with
+// Jaccard similarity 0.4 is found about 55% of the time and one at 0.6
+// more than 98% of the time, while pairs below 0.2 rarely are.
+const int LSH_BANDS = 32;
+const int LSH_ROWS = MINHASH_SIZE / LSH_BANDS;
+
+// Function to scramble a 64-bit value so every input bit affects every
+// output bit (the splitmix64 finalizer)
+inline uint64_t mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+struct Signature {
+    uint32_t values[MINHASH_SIZE];
+};
+
+// Builds a signature from a stream of word hashes (see hashWord), so it does
+// not depend on any dictionary's ids
+class MinHasher {
+public:
+    MinHasher();
+    void add(uint64_t wordHash);
+
+    // Function to write the signature so far into `out` and start over
+    void finish(Signature& out);
+
+private:
+    void addShingle(uint64_t shingle);
+
+    uint64_t window[SHINGLE_SIZE];
+    size_t words = 0;
+    uint32_t mins[MINHASH_SIZE];
+};
+
+double estimateJaccard(const Signature& a, const Signature& b);
+
+// Signatures of a document corpus with an LSH index over them. New
+// documents can be checked and added one at a time, and the signatures
+// saved, so a corpus is never rescanned; bands are rebuilt on load.
+//
+// File layout (native byte order):
+//   "SIG1" | u32 documents | u32 MINHASH_SIZE |
+//   per document: u32 name length, name bytes | signatures
+class SignatureIndex {
+public:
+    // Function to add a document, or replace the signature of the one
+    // already indexed under `name`, returning its id
+    uint32_t add(const string& name, const Signature& signature);
+
+    // Function to list the documents sharing at least one band with
+    // `signature`, each once, in insertion order
+    void candidates(const Signature& signature, vector<uint32_t>& out) const;
+
+    size_t size() const { return names.size(); }
+    const string& name(uint32_t id) const { return names[id]; }
+    const Signature& signature(uint32_t id) const { return signatures[id]; }
+
+    bool save(const string& filename) const;
+    bool load(const string& filename);
+
+private:
+    static uint64_t bandKey(const Signature& signature, int band);
+
+    vector<string> names;
+    vector<Signature> signatures;
+    unordered_map<string, uint32_t> ids;
+    unordered_map<uint64_t, vector<uint32_t>> buckets;
+};
+
+#endif
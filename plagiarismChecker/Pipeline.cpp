@@ -0,0 +1,338 @@
+#include "Pipeline.h"
+#include "Tokenizer.h"
+#include "TermVector.h"
+#include "MinHash.h"
+#include "TextFile.h"
+#include <fstream>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <unordered_set>
+
+struct BatchDocument {
+    TermVector terms;
+    Signature signature;
+    bool ok = false;
+};
+
+// Work for a scoring thread: one document against its candidates
+struct ScoreJob {
+    uint32_t document;
+    vector<uint32_t> others;
+};
+
+static double now() {
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static unsigned threadCount(unsigned requested) {
+    return requested > 0 ? requested : max(1u, thread::hardware_concurrency());
+}
+
+// Per-thread reading state. Words go into a private dictionary without
+// locking; `global` caches the shared id of each private one, so the shared
+// dictionary is locked once per document, and only for words this thread
+// has not seen before.
+class BatchReader {
+public:
+    BatchReader(Dictionary& shared, mutex& sharedGuard) : shared(shared), sharedGuard(sharedGuard) {}
+
+    bool read(const string& filename, BatchDocument& document, uint64_t& bytes) {
+        TextFile file;
+        if (!file.open(filename)) {
+            cerr << "Error opening file: " << filename << endl;
+            return false;
+        }
+
+        auto emit = [&](string_view word) {
+            counter.add(local.intern(word));
+            hasher.add(hashWord(word));
+        };
+        const char* data;
+        size_t n;
+        while ((n = file.next(data)) > 0) {
+            tokenizer.feed(data, n, emit);
+            bytes += n;
+        }
+        tokenizer.finish(emit);
+        counter.finish(document.terms);
+        hasher.finish(document.signature);
+        if (file.failed()) {
+            cerr << "Error reading file: " << filename << endl;
+            return false;
+        }
+
+        toShared(document.terms);
+        return document.terms.total > 0;
+    }
+
+private:
+    void toShared(TermVector& terms) {
+        if (global.size() < local.size()) global.resize(local.size(), Dictionary::NOT_FOUND);
+
+        bool unmapped = false;
+        for (auto& term : terms.terms) unmapped = unmapped || global[term.first] == Dictionary::NOT_FOUND;
+        if (unmapped) {
+            lock_guard<mutex> lock(sharedGuard);
+            for (auto& term : terms.terms) {
+                if (global[term.first] == Dictionary::NOT_FOUND) global[term.first] = shared.intern(local.word(term.first));
+            }
+        }
+
+        for (auto& term : terms.terms) term.first = global[term.first];
+        sort(terms.terms.begin(), terms.terms.end());
+    }
+
+    Dictionary& shared;
+    mutex& sharedGuard;
+    Dictionary local;
+    vector<uint32_t> global;
+    Tokenizer tokenizer;
+    TermCounter counter;
+    MinHasher hasher;
+};
+
+bool runBatch(const vector<string>& files, const BatchOptions& options, Dictionary& dictionary,
+              vector<BatchPair>& pairs, BatchStats& stats) {
+    double start = now();
+    stats = BatchStats();
+    pairs.clear();
+
+    // One slot per file, written by exactly one reader before its index
+    // goes through the queue
+    vector<BatchDocument> documents(files.size());
+    BoundedQueue<uint32_t> readQueue(options.queueSize);
+    BoundedQueue<ScoreJob> scoreQueue(options.queueSize);
+    atomic<size_t> nextFile(0);
+    mutex dictionaryGuard;
+
+    unsigned readerCount = threadCount(options.readers);
+    unsigned scorerCount = threadCount(options.scorers);
+    vector<double> readBusy(readerCount, 0), scoreBusy(scorerCount, 0);
+    vector<uint64_t> readBytes(readerCount, 0);
+    vector<vector<BatchPair>> found(scorerCount);
+
+    vector<thread> readers;
+    for (unsigned r = 0; r < readerCount; ++r) {
+        readers.emplace_back([&, r] {
+            BatchReader reader(dictionary, dictionaryGuard);
+            size_t k;
+            while ((k = nextFile++) < files.size()) {
+                double begin = now();
+                documents[k].ok = reader.read(files[k], documents[k], readBytes[r]);
+                readBusy[r] += now() - begin;
+                readQueue.push(static_cast<uint32_t>(k));
+            }
+        });
+    }
+
+    vector<thread> scorers;
+    for (unsigned s = 0; s < scorerCount; ++s) {
+        scorers.emplace_back([&, s] {
+            ScoreJob job;
+            while (scoreQueue.pop(job)) {
+                double begin = now();
+                const BatchDocument& document = documents[job.document];
+                for (uint32_t other : job.others) {
+                    double similarity = termSimilarity(document.terms, documents[other].terms);
+                    if (similarity < options.threshold) continue;
+                    found[s].push_back({ min(job.document, other), max(job.document, other), similarity,
+                                         estimateJaccard(document.signature, documents[other].signature) });
+                }
+                scoreBusy[s] += now() - begin;
+            }
+        });
+    }
+
+    // Indexing runs on this thread, in the order documents finish reading
+    SignatureIndex index;
+    vector<uint32_t> indexed; // file of each index entry
+    vector<uint32_t> candidates;
+    for (size_t received = 0; received < files.size(); ++received) {
+        uint32_t k = 0;
+        readQueue.pop(k);
+        if (!documents[k].ok) {
+            cerr << "Skipping " << files[k] << ": it could not be processed." << endl;
+            stats.failed++;
+            continue;
+        }
+
+        double begin = now();
+        ScoreJob job{ k, {} };
+        if (options.allPairs) {
+            // As with the index below, a file listed twice is not scored
+            // against itself and replaces its own entry
+            size_t own = indexed.size();
+            for (size_t i = 0; i < indexed.size(); ++i) {
+                if (files[indexed[i]] == files[k]) {
+                    own = i;
+                } else {
+                    job.others.push_back(indexed[i]);
+                }
+            }
+            if (own == indexed.size()) {
+                indexed.push_back(k);
+            } else {
+                indexed[own] = k;
+            }
+        } else {
+            index.candidates(documents[k].signature, candidates);
+            for (uint32_t id : candidates) {
+                if (files[indexed[id]] != files[k]) job.others.push_back(indexed[id]);
+            }
+            // A file listed twice replaces its own entry
+            uint32_t id = index.add(files[k], documents[k].signature);
+            if (id == indexed.size()) {
+                indexed.push_back(k);
+            } else {
+                indexed[id] = k;
+            }
+        }
+        stats.candidates += job.others.size();
+        stats.indexSeconds += now() - begin;
+
+        if (!job.others.empty()) scoreQueue.push(move(job));
+    }
+    readQueue.close();
+    scoreQueue.close();
+
+    for (thread& reader : readers) reader.join();
+    for (thread& scorer : scorers) scorer.join();
+
+    for (unsigned r = 0; r < readerCount; ++r) {
+        stats.readSeconds += readBusy[r];
+        stats.bytes += readBytes[r];
+    }
+    for (unsigned s = 0; s < scorerCount; ++s) {
+        stats.scoreSeconds += scoreBusy[s];
+        pairs.insert(pairs.end(), found[s].begin(), found[s].end());
+    }
+    sort(pairs.begin(), pairs.end(), [](const BatchPair& x, const BatchPair& y) {
+        return x.a != y.a ? x.a < y.a : x.b < y.b;
+    });
+
+    stats.documents = files.size() - stats.failed;
+    stats.wallSeconds = now() - start;
+    return stats.failed == 0;
+}
+
+static bool readList(const string& list, vector<string>& files) {
+    ifstream file;
+    if (list != "-") {
+        file.open(list);
+        if (!file.is_open()) {
+            cerr << "Error opening file: " << list << endl;
+            return false;
+        }
+    }
+    istream& in = list == "-" ? cin : file;
+
+    string line;
+    while (getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (!line.empty()) files.push_back(line);
+    }
+    return true;
+}
+
+bool collectFiles(const vector<string>& paths, const vector<string>& lists, vector<string>& files) {
+    for (const string& list : lists) {
+        if (!readList(list, files)) return false;
+    }
+
+    for (const string& path : paths) {
+        error_code error;
+        if (!filesystem::is_directory(path, error)) {
+            files.push_back(path);
+            continue;
+        }
+
+        vector<string> found;
+        for (auto it = filesystem::recursive_directory_iterator(path, error);
+             !error && it != filesystem::recursive_directory_iterator(); it.increment(error)) {
+            if (it->is_regular_file(error)) found.push_back(it->path().string());
+        }
+        if (error) {
+            cerr << "Error reading directory: " << path << endl;
+            return false;
+        }
+        sort(found.begin(), found.end());
+        files.insert(files.end(), found.begin(), found.end());
+    }
+
+    // A file named twice, e.g. on the command line and in a directory, is
+    // checked once, at its first place
+    unordered_set<string> seen;
+    files.erase(remove_if(files.begin(), files.end(), [&](const string& name) { return !seen.insert(name).second; }),
+                files.end());
+    return true;
+}
+
+static void writeCsvField(ostream& out, const string& field) {
+    if (field.find_first_of(",\"\r\n") == string::npos) {
+        out << field;
+        return;
+    }
+    out << '"';
+    for (char ch : field) {
+        if (ch == '"') out << '"';
+        out << ch;
+    }
+    out << '"';
+}
+
+static void writeJsonString(ostream& out, const string& text) {
+    const char* hex = "0123456789abcdef";
+    out << '"';
+    for (unsigned char ch : text) {
+        if (ch == '"' || ch == '\\') {
+            out << '\\' << ch;
+        } else if (ch < 0x20) {
+            out << "\\u00" << hex[ch >> 4] << hex[ch & 15];
+        } else {
+            out << ch;
+        }
+    }
+    out << '"';
+}
+
+void writeBatchCsv(ostream& out, const vector<string>& files, const vector<BatchPair>& pairs) {
+    out << "file1,file2,similarity,overlap\n";
+    for (const BatchPair& pair : pairs) {
+        writeCsvField(out, files[pair.a]);
+        out << ',';
+        writeCsvField(out, files[pair.b]);
+        out << ',' << pair.similarity << ',' << pair.overlap * 100 << '\n';
+    }
+}
+
+void writeBatchJson(ostream& out, const vector<string>& files, const vector<BatchPair>& pairs,
+                    const BatchStats& stats) {
+    out << "{\n  \"documents\": " << stats.documents << ",\n  \"failed\": " << stats.failed
+        << ",\n  \"bytes\": " << stats.bytes << ",\n  \"candidates\": " << stats.candidates
+        << ",\n  \"seconds\": " << stats.wallSeconds << ",\n  \"pairs\": [";
+    for (size_t i = 0; i < pairs.size(); ++i) {
+        out << (i > 0 ? ",\n    " : "\n    ") << "{\"file1\": ";
+        writeJsonString(out, files[pairs[i].a]);
+        out << ", \"file2\": ";
+        writeJsonString(out, files[pairs[i].b]);
+        out << ", \"similarity\": " << pairs[i].similarity << ", \"overlap\": " << pairs[i].overlap * 100 << "}";
+    }
+    out << (pairs.empty() ? "]\n}\n" : "\n  ]\n}\n");
+}
+
+static double mbps(uint64_t bytes, double seconds) {
+    return seconds > 0 ? bytes / seconds / 1e6 : 0;
+}
+
+void printBatchStats(ostream& out, const BatchStats& stats) {
+    out << "Checked " << stats.documents << " documents (" << stats.bytes / 1e6 << " MB) in " << stats.wallSeconds
+        << " s: " << (stats.wallSeconds > 0 ? stats.documents / stats.wallSeconds : 0) << " docs/s, "
+        << mbps(stats.bytes, stats.wallSeconds) << " MB/s; " << stats.candidates << " pairs scored." << endl;
+    out << "Per thread: read+tokenize " << mbps(stats.bytes, stats.readSeconds) << " MB/s, index "
+        << mbps(stats.bytes, stats.indexSeconds) << " MB/s, score " << mbps(stats.bytes, stats.scoreSeconds)
+        << " MB/s" << endl;
+}
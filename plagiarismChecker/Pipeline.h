@@ -0,0 +1,105 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+#include "Dictionary.h"
+
+using namespace std;
+
+// Blocking FIFO holding at most `capacity` items, so a fast producer
+// waits for its consumers instead of filling memory
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity(capacity) {}
+
+    void push(T item) {
+        unique_lock<mutex> lock(guard);
+        notFull.wait(lock, [&] { return items.size() < capacity; });
+        items.push_back(move(item));
+        notEmpty.notify_one();
+    }
+
+    // Function to take the oldest item, waiting for one; false once the
+    // queue is closed and drained
+    bool pop(T& item) {
+        unique_lock<mutex> lock(guard);
+        notEmpty.wait(lock, [&] { return !items.empty() || closed; });
+        if (items.empty()) return false;
+        item = move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    void close() {
+        lock_guard<mutex> lock(guard);
+        closed = true;
+        notEmpty.notify_all();
+    }
+
+private:
+    size_t capacity;
+    deque<T> items;
+    bool closed = false;
+    mutex guard;
+    condition_variable notEmpty;
+    condition_variable notFull;
+};
+
+struct BatchOptions {
+    unsigned readers = 0;   // threads reading and tokenizing; 0 for one per core
+    unsigned scorers = 0;   // threads scoring pairs; 0 for one per core
+    size_t queueSize = 256; // documents read ahead of indexing
+    bool allPairs = false;  // score every pair instead of LSH candidates only
+    double threshold = 0;   // report pairs scoring at least this percentage
+};
+
+// A scored pair of documents, by index into the file list, a < b
+struct BatchPair {
+    uint32_t a, b;
+    double similarity;
+    double overlap; // estimated shingle Jaccard similarity
+};
+
+// Busy time of each stage summed over its threads, so MB/s per stage is
+// what one thread of it sustains
+struct BatchStats {
+    size_t documents = 0;
+    size_t failed = 0;
+    uint64_t bytes = 0;
+    size_t candidates = 0;
+    double readSeconds = 0;  // mapping, normalizing, tokenizing, counting
+    double indexSeconds = 0; // signature index insertion and lookup
+    double scoreSeconds = 0;
+    double wallSeconds = 0;
+};
+
+// Function to check every file against every other in three stages: reader
+// threads tokenize files into term vectors and signatures and hand them
+// through a bounded queue to one indexing thread, which passes each
+// document's LSH candidates (or all earlier documents) to scoring threads.
+// Readers intern into private dictionaries and map new words into the
+// shared one under a lock once each, so they rarely contend. `pairs` comes
+// back sorted.
+bool runBatch(const vector<string>& files, const BatchOptions& options, Dictionary& dictionary,
+              vector<BatchPair>& pairs, BatchStats& stats);
+
+// Function to expand directories (recursively, sorted) and list files
+// ("-" for stdin, one name per line) into a list of files, keeping only the
+// first of repeated names
+bool collectFiles(const vector<string>& paths, const vector<string>& lists, vector<string>& files);
+
+void writeBatchCsv(ostream& out, const vector<string>& files, const vector<BatchPair>& pairs);
+void writeBatchJson(ostream& out, const vector<string>& files, const vector<BatchPair>& pairs,
+                    const BatchStats& stats);
+void printBatchStats(ostream& out, const BatchStats& stats);
+
+#endif
@@ -0,0 +1,33 @@
+#include "TermVector.h"
+#include <algorithm>
+
+void TermCounter::finish(TermVector& out) {
+    sort(seen.begin(), seen.end());
+    out.terms.resize(seen.size());
+    for (size_t i = 0; i < seen.size(); ++i) {
+        out.terms[i] = { seen[i], counts[seen[i]] };
+        counts[seen[i]] = 0;
+    }
+    out.total = total;
+    seen.clear();
+    total = 0;
+}
+
+double termSimilarity(const TermVector& a, const TermVector& b) {
+    if (a.total + b.total == 0) return 0;
+
+    uint64_t common = 0;
+    size_t i = 0, j = 0;
+    while (i < a.terms.size() && j < b.terms.size()) {
+        if (a.terms[i].first < b.terms[j].first) {
+            i++;
+        } else if (a.terms[i].first > b.terms[j].first) {
+            j++;
+        } else {
+            common += min(a.terms[i].second, b.terms[j].second);
+            i++;
+            j++;
+        }
+    }
+    return 2.0 * common / (a.total + b.total) * 100;
+}
@@ -0,0 +1,44 @@
+#ifndef TERMVECTOR_H
+#define TERMVECTOR_H
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+// Word counts of one document as (word id, count) pairs sorted by id, so
+// two documents compare with a linear merge and no hashing
+struct TermVector {
+    vector<pair<uint32_t, uint32_t>> terms;
+    size_t total = 0; // words in the document, repeats included
+};
+
+// Accumulates word ids into a TermVector. Counts go into a dense array by
+// id, and only the ids actually seen are sorted and cleared afterwards, so
+// one counter serves many documents at a cost per document proportional to
+// its length.
+class TermCounter {
+public:
+    void add(uint32_t id) {
+        if (id >= counts.size()) counts.resize(max<size_t>(id + 1, 2 * counts.size()), 0);
+        if (counts[id]++ == 0) seen.push_back(id);
+        total++;
+    }
+
+    // Function to move the counts so far into `out` and start over
+    void finish(TermVector& out);
+
+private:
+    std::vector<uint32_t> counts;
+    std::vector<uint32_t> seen;
+    size_t total = 0;
+};
+
+// Function to score two documents: twice the shared word occurrences over
+// all words, as a percentage
+double termSimilarity(const TermVector& a, const TermVector& b);
+
+#endif
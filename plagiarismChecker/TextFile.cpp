@@ -0,0 +1,56 @@
+#include "TextFile.h"
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// Read size for files that are not memory-mapped
+const size_t TEXT_BLOCK_SIZE = 1 << 20;
+
+TextFile::~TextFile() {
+#ifndef _WIN32
+    if (mapping != nullptr) munmap(const_cast<char*>(mapping), fileSize);
+#endif
+    if (file != nullptr) fclose(file);
+}
+
+bool TextFile::open(const string& name) {
+    file = fopen(name.c_str(), "rb");
+    if (file == nullptr) return false;
+
+#ifndef _WIN32
+    struct stat info;
+    if (fstat(fileno(file), &info) == 0 && S_ISREG(info.st_mode)) {
+        fileSize = info.st_size;
+        if (fileSize == 0) {
+            isMapped = true;
+            return true;
+        }
+        void* map = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+        if (map != MAP_FAILED) {
+            madvise(map, fileSize, MADV_SEQUENTIAL);
+            mapping = static_cast<const char*>(map);
+            isMapped = true;
+            return true;
+        }
+    }
+#endif
+    return true;
+}
+
+size_t TextFile::next(const char*& data) {
+    if (isMapped) {
+        size_t got = fileSize - pos;
+        data = mapping + pos;
+        pos = fileSize;
+        return got;
+    }
+
+    block.resize(TEXT_BLOCK_SIZE);
+    size_t got = fread(block.data(), 1, block.size(), file);
+    if (got < block.size() && ferror(file)) error = true;
+    data = block.data();
+    pos += got;
+    return got;
+}
@@ -0,0 +1,41 @@
+#ifndef TEXTFILE_H
+#define TEXTFILE_H
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+// Read-only text file that is memory-mapped when it is a regular file, so
+// the whole content is handed out in place with no copy, and read in large
+// blocks otherwise (pipes, or where mapping fails).
+class TextFile {
+public:
+    TextFile() = default;
+    ~TextFile();
+    TextFile(const TextFile&) = delete;
+    TextFile& operator=(const TextFile&) = delete;
+
+    bool open(const string& name);
+    uint64_t size() const { return fileSize; }
+    bool failed() const { return error; }
+
+    // Points `data` at the next part of the file and returns its length,
+    // 0 at the end: the whole mapping at once, or one block at a time. The
+    // data stays valid until the next call.
+    size_t next(const char*& data);
+
+private:
+    FILE* file = nullptr;
+    const char* mapping = nullptr;
+    bool isMapped = false;
+    bool error = false;
+    uint64_t fileSize = 0;
+    uint64_t pos = 0;
+    vector<char> block;
+};
+
+#endif
@@ -0,0 +1,194 @@
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+#include "CharClass.h"
+#include "TextFile.h"
+
+using namespace std;
+
+// Single-pass normalizer and splitter. Text is fed in blocks of any size and
+// every word is passed to emit(string_view). A word that is already
+// normalized and lies within one block is a view straight into that block;
+// only words that need lowercasing, lose dropped characters, hold non-ASCII
+// characters or straddle two blocks are rebuilt, in one reused buffer.
+// Views are valid only during the emit call. An emit that also takes two
+// uint64_t is passed the byte range [begin, end) the word spans in the
+// whole text.
+//
+// ASCII text is scanned with ByteScanner, which classifies 64 bytes per
+// step with SIMD compares, so finding where a plain lowercase word ends
+// costs no per-byte branches. Text is read as UTF-8: accented and other
+// non-ASCII letters are word characters (lowercased where classifyCodepoint
+// knows how), Unicode spaces split words and invalid bytes are dropped.
+class Tokenizer {
+public:
+    template <typename F>
+    void feed(const char* data, size_t n, F emit) {
+        const CharTable& table = charTable();
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+        ByteScanner scanner(bytes, n);
+
+        size_t i = carryLength > 0 ? finishCarry(bytes, n, emit) : 0;
+        while (i < n) {
+            if (!inWord) {
+                i = scanner.nextStart(i);
+                if (i == n) break;
+                if (bytes[i] >= 0x80) {
+                    i = decodeAt(bytes, i, n, emit);
+                    continue;
+                }
+                inWord = true;
+                wordBegin = consumed + i;
+            }
+
+            if (pending.empty()) {
+                size_t start = i;
+                i = scanner.nextUnclean(i);
+                if (i < n && table.cls[bytes[i]] == CHAR_SPACE) {
+                    call(emit, string_view(data + start, i - start), consumed + i);
+                    inWord = false;
+                    continue;
+                }
+                pending.append(data + start, i - start);
+            }
+
+            // The word needs rebuilding; at the end of the block it may go
+            // on in the next one
+            while (i < n && inWord) {
+                uint8_t c = bytes[i];
+                if (c >= 0x80) {
+                    i = decodeAt(bytes, i, n, emit);
+                } else if (table.cls[c] == CHAR_SPACE) {
+                    endWord(emit, consumed + i);
+                } else if (table.cls[c] == CHAR_WORD && table.lower[c] == data[i]) {
+                    size_t end = scanner.nextUnclean(i);
+                    pending.append(data + i, end - i);
+                    i = end;
+                } else {
+                    if (table.cls[c] == CHAR_WORD) pending += table.lower[c];
+                    i++;
+                }
+            }
+        }
+        consumed += n;
+    }
+
+    // Function to emit the word cut off by the end of the text, if any; an
+    // unfinished UTF-8 sequence there is dropped
+    template <typename F>
+    void finish(F emit) {
+        if (inWord && !pending.empty()) call(emit, string_view(pending), consumed - carryLength);
+        pending.clear();
+        inWord = false;
+        consumed = 0;
+        carryLength = 0;
+    }
+
+private:
+    template <typename F>
+    void call(F& emit, string_view word, uint64_t end) {
+        if constexpr (is_invocable_v<F&, string_view, uint64_t, uint64_t>) {
+            emit(word, wordBegin, end);
+        } else {
+            emit(word);
+        }
+    }
+
+    template <typename F>
+    void endWord(F& emit, uint64_t end) {
+        call(emit, string_view(pending), end);
+        pending.clear();
+        inWord = false;
+    }
+
+    // Function to apply one decoded non-ASCII character at offset `begin`
+    template <typename F>
+    void addCodepoint(uint32_t cp, uint64_t begin, F& emit) {
+        uint32_t lower;
+        CharClass cls = classifyCodepoint(cp, lower);
+        if (cls == CHAR_WORD) {
+            if (!inWord) {
+                inWord = true;
+                wordBegin = begin;
+            }
+            appendUtf8(pending, lower);
+        } else if (cls == CHAR_SPACE && inWord) {
+            endWord(emit, begin);
+        }
+    }
+
+    // Function to decode and apply the UTF-8 sequence at bytes[i], returning
+    // where the next character starts. A sequence cut off by the end of the
+    // block is kept in `carry` for the next one.
+    template <typename F>
+    size_t decodeAt(const uint8_t* bytes, size_t i, size_t n, F& emit) {
+        uint32_t cp;
+        size_t length = decodeUtf8(bytes + i, n - i, cp);
+        if (length == 0) {
+            carryLength = n - i;
+            for (size_t k = 0; k < carryLength; ++k) carry[k] = bytes[i + k];
+            return n;
+        }
+        if (cp != INVALID_CODEPOINT) addCodepoint(cp, consumed + i, emit);
+        return i + length;
+    }
+
+    // Function to complete the sequence carried over from the last block
+    // with the first bytes of this one, returning where to go on from
+    template <typename F>
+    size_t finishCarry(const uint8_t* bytes, size_t n, F& emit) {
+        uint64_t begin = consumed - carryLength;
+        uint32_t cp = INVALID_CODEPOINT;
+        size_t i = 0, length = 0;
+        while (length == 0 && i < n) {
+            carry[carryLength++] = bytes[i++];
+            length = decodeUtf8(carry, carryLength, cp);
+        }
+        if (length == 0) return n;
+
+        carryLength = 0;
+        // The carried bytes were a valid start, so only the byte just added
+        // can have broken the sequence; it is looked at again on its own
+        if (cp == INVALID_CODEPOINT) return i - 1;
+        addCodepoint(cp, begin, emit);
+        return i;
+    }
+
+    string pending;
+    bool inWord = false;
+    uint64_t consumed = 0;  // bytes fed before the current block
+    uint64_t wordBegin = 0;
+    uint8_t carry[4];
+    size_t carryLength = 0;
+};
+
+// Function to tokenize a whole file, memory-mapped where possible; returns
+// false if it cannot be read
+template <typename F>
+bool tokenizeFile(const string& filename, F emit) {
+    TextFile file;
+    if (!file.open(filename)) {
+        cerr << "Error opening file: " << filename << endl;
+        return false;
+    }
+
+    Tokenizer tokenizer;
+    const char* data;
+    size_t n;
+    while ((n = file.next(data)) > 0) tokenizer.feed(data, n, emit);
+    tokenizer.finish(emit);
+
+    if (file.failed()) {
+        cerr << "Error reading file: " << filename << endl;
+        return false;
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,414 @@
+// Throughput benchmark: writes a synthetic corpus (Zipf-distributed words,
+// with some near-copies) or takes existing files and directories, times
+// each checker stage on one thread and then the whole batch pipeline at
+// several thread counts, and reports docs/s, MB/s and peak RSS as CSV or
+// JSON, for sizing hardware and comparing versions.
+//
+// Peak RSS on the single-thread rows is the benchmark's own, which holds
+// the whole corpus in memory. Each pipeline thread count runs in a child
+// process forked before the corpus is loaded, so its rows report the peak
+// of that pipeline run alone (on Windows, where RSS is not reported, the
+// runs happen in-process).
+//
+// Build from the plagiarismChecker directory:
+//   g++ -O2 -std=c++17 -pthread bench/bench.cpp TextFile.cpp Dictionary.cpp TermVector.cpp MinHash.cpp Pipeline.cpp -o bench
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <filesystem>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+#include "../TextFile.h"
+#include "../Tokenizer.h"
+#include "../Dictionary.h"
+#include "../TermVector.h"
+#include "../MinHash.h"
+#include "../Pipeline.h"
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+const size_t VOCABULARY_SIZE = 20000;
+const double NEAR_COPY_SHARE = 0.05;
+const size_t MAX_SCORED_DOCUMENTS = 500;
+
+// One benchmark row; rates are negative when they do not apply
+struct Result {
+    string stage;
+    unsigned threads = 1;
+    size_t items = 0; // documents, or pairs for scoring
+    uint64_t bytes = 0;
+    double seconds = 0;
+    double itemsPerSecond = -1;
+    double mbps = -1;
+    long peakRssKiB = 0;
+};
+
+static double now() {
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static double mbps(uint64_t bytes, double seconds) {
+    return seconds > 0 ? bytes / seconds / 1e6 : 0;
+}
+
+// Peak resident set size of the process so far
+static long peakRssKiB() {
+#ifndef _WIN32
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+#else
+    return 0;
+#endif
+}
+
+static Result makeResult(const string& stage, unsigned threads, size_t items, uint64_t bytes, double seconds) {
+    Result r;
+    r.stage = stage;
+    r.threads = threads;
+    r.items = items;
+    r.bytes = bytes;
+    r.seconds = seconds;
+    r.itemsPerSecond = seconds > 0 ? items / seconds : 0;
+    r.mbps = bytes > 0 ? mbps(bytes, seconds) : -1;
+    r.peakRssKiB = peakRssKiB();
+    return r;
+}
+
+// Outcome of one batch pipeline run
+struct PipelineRun {
+    BatchStats stats;
+    bool ok = false;
+    long peakRssKiB = 0;
+};
+
+static PipelineRun runPipeline(const vector<string>& files, unsigned threads) {
+    BatchOptions options;
+    options.readers = options.scorers = threads;
+    Dictionary dictionary;
+    vector<BatchPair> pairs;
+    PipelineRun run;
+    run.ok = runBatch(files, options, dictionary, pairs, run.stats);
+    run.peakRssKiB = peakRssKiB();
+    return run;
+}
+
+// Function to run the pipeline in a fresh child process, so the peak RSS it
+// reports is the pipeline's and not what earlier runs left behind; false if
+// the child could not be started or died
+static bool measurePipeline(const vector<string>& files, unsigned threads, PipelineRun& run) {
+#ifndef _WIN32
+    int channel[2];
+    if (pipe(channel) != 0) return false;
+    cout.flush();
+    cerr.flush();
+    pid_t child = fork();
+    if (child < 0) {
+        close(channel[0]);
+        close(channel[1]);
+        return false;
+    }
+    if (child == 0) {
+        close(channel[0]);
+        PipelineRun result = runPipeline(files, threads);
+        bool sent = write(channel[1], &result, sizeof(result)) == static_cast<ssize_t>(sizeof(result));
+        _exit(sent ? 0 : 1);
+    }
+
+    close(channel[1]);
+    size_t received = 0;
+    char* buffer = reinterpret_cast<char*>(&run);
+    while (received < sizeof(run)) {
+        ssize_t n = read(channel[0], buffer + received, sizeof(run) - received);
+        if (n <= 0) break;
+        received += n;
+    }
+    close(channel[0]);
+    int status = 0;
+    waitpid(child, &status, 0);
+    return received == sizeof(run) && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+#else
+    run = runPipeline(files, threads);
+    return true;
+#endif
+}
+
+// Function to write `documents` files of about `words` words each into
+// `directory`. Word ranks follow a Zipf law, words are sometimes
+// capitalized or punctuated, and a few documents are edited copies of
+// earlier ones so the scoring stages have matches to report.
+static bool writeCorpus(const string& directory, size_t documents, size_t words, vector<string>& files) {
+    mt19937_64 rng(42);
+    vector<string> vocabulary(VOCABULARY_SIZE);
+    for (string& word : vocabulary) {
+        size_t length = 2 + rng() % 9;
+        for (size_t c = 0; c < length; ++c) word += static_cast<char>('a' + rng() % 26);
+    }
+    vector<double> cumulative(VOCABULARY_SIZE);
+    double total = 0;
+    for (size_t rank = 0; rank < VOCABULARY_SIZE; ++rank) cumulative[rank] = total += 1.0 / (rank + 1);
+    uniform_real_distribution<double> uniform(0, total);
+    auto sample = [&]() -> size_t {
+        return lower_bound(cumulative.begin(), cumulative.end(), uniform(rng)) - cumulative.begin();
+    };
+
+    error_code error;
+    filesystem::create_directories(directory, error);
+    vector<vector<size_t>> texts;
+    for (size_t d = 0; d < documents; ++d) {
+        vector<size_t> text;
+        if (d > 0 && rng() % 1000 < NEAR_COPY_SHARE * 1000) {
+            text = texts[rng() % d];
+            for (size_t& w : text) {
+                if (rng() % 10 == 0) w = sample();
+            }
+        } else {
+            for (size_t w = 0; w < words; ++w) text.push_back(sample());
+        }
+
+        string name = directory + "/doc" + to_string(d) + ".txt";
+        ofstream out(name, ios::binary);
+        for (size_t w = 0; w < text.size(); ++w) {
+            string word = vocabulary[text[w]];
+            if (rng() % 16 == 0) word[0] = static_cast<char>(word[0] - 'a' + 'A');
+            if (rng() % 12 == 0) word += rng() % 2 ? "," : ".";
+            out << word << (w % 12 == 11 ? '\n' : ' ');
+        }
+        if (!out) {
+            cerr << "Error writing file: " << name << endl;
+            return false;
+        }
+        texts.push_back(move(text));
+        files.push_back(name);
+    }
+    return true;
+}
+
+// Function to run `body` `reps` times and return the fastest time
+template <typename F>
+static double fastest(int reps, F body) {
+    double best = 1e30;
+    for (int rep = 0; rep < reps; ++rep) {
+        double start = now();
+        body();
+        best = min(best, now() - start);
+    }
+    return best;
+}
+
+static string number(double value) {
+    if (value < 0) return "";
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.2f", value);
+    return buffer;
+}
+
+static void printCsv(const vector<Result>& results) {
+    cout << "stage,threads,items,bytes,seconds,items_per_s,mbps,peak_rss_kib" << endl;
+    for (const Result& r : results) {
+        cout << r.stage << ',' << r.threads << ',' << r.items << ',' << r.bytes << ',' << number(r.seconds) << ','
+             << number(r.itemsPerSecond) << ',' << number(r.mbps) << ',' << r.peakRssKiB << endl;
+    }
+}
+
+static string jsonNumber(double value) {
+    return value < 0 ? "null" : number(value);
+}
+
+static void printJson(const vector<Result>& results) {
+    cout << "[" << endl;
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        cout << "  {\"stage\": \"" << r.stage << "\", \"threads\": " << r.threads << ", \"items\": " << r.items
+             << ", \"bytes\": " << r.bytes << ", \"seconds\": " << number(r.seconds)
+             << ", \"items_per_s\": " << jsonNumber(r.itemsPerSecond) << ", \"mbps\": " << jsonNumber(r.mbps)
+             << ", \"peak_rss_kib\": " << r.peakRssKiB << "}" << (i + 1 < results.size() ? "," : "") << endl;
+    }
+    cout << "]" << endl;
+}
+
+static void printUsage(const char* program) {
+    cerr << "Usage: " << program << " [options] [corpus files or directories...]" << endl;
+    cerr << "Options:" << endl;
+    cerr << "  -f <csv|json>  output format (default: csv)" << endl;
+    cerr << "  -r <reps>      repetitions per single-thread stage, fastest is kept (default: 3)" << endl;
+    cerr << "  -n <docs>      documents in the generated corpus (default: 2000)" << endl;
+    cerr << "  -w <words>     words per generated document (default: 1000)" << endl;
+    cerr << "  -j <threads>   largest pipeline thread count, doubling from 1 (default: one per core)" << endl;
+    cerr << "  -d <dir>       write the generated corpus here and keep it" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    bool json = false;
+    int reps = 3;
+    size_t documents = 2000;
+    size_t words = 1000;
+    unsigned maxThreads = max(1u, thread::hardware_concurrency());
+    string directory;
+    vector<string> paths;
+
+    for (int arg = 1; arg < argc; ++arg) {
+        string flag = argv[arg];
+        if (flag == "-f" && arg + 1 < argc) {
+            string format = argv[++arg];
+            if (format != "csv" && format != "json") {
+                printUsage(argv[0]);
+                return 1;
+            }
+            json = format == "json";
+        } else if (flag == "-r" && arg + 1 < argc) {
+            reps = max(1, atoi(argv[++arg]));
+        } else if (flag == "-n" && arg + 1 < argc) {
+            documents = max(2, atoi(argv[++arg]));
+        } else if (flag == "-w" && arg + 1 < argc) {
+            words = max(1, atoi(argv[++arg]));
+        } else if (flag == "-j" && arg + 1 < argc) {
+            maxThreads = max(1, atoi(argv[++arg]));
+        } else if (flag == "-d" && arg + 1 < argc) {
+            directory = argv[++arg];
+        } else if (!flag.empty() && flag[0] == '-') {
+            printUsage(argv[0]);
+            return 1;
+        } else {
+            paths.push_back(flag);
+        }
+    }
+
+    vector<string> files;
+    bool generated = paths.empty();
+    bool keep = !directory.empty();
+    if (generated) {
+        if (directory.empty()) directory = (filesystem::temp_directory_path() / "plagiarism_bench").string();
+        if (!writeCorpus(directory, documents, words, files)) return 1;
+    } else if (!collectFiles(paths, {}, files)) {
+        return 1;
+    }
+
+    // The whole pipeline, reading from disk, at 1, 2, 4, ... threads per
+    // stage, before anything else is loaded; the per-stage rows use busy
+    // time summed over that stage's threads
+    vector<unsigned> threadCounts;
+    for (unsigned t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+    bool ok = true;
+    vector<Result> pipelineResults;
+    for (unsigned t : threadCounts) {
+        PipelineRun run;
+        if (!measurePipeline(files, t, run)) {
+            cerr << "Pipeline run with " << t << " threads failed" << endl;
+            ok = false;
+            continue;
+        }
+        ok &= run.ok;
+        const BatchStats& stats = run.stats;
+        pipelineResults.push_back(makeResult("pipeline", t, stats.documents, stats.bytes, stats.wallSeconds));
+        pipelineResults.push_back(makeResult("pipeline-read+tokenize", t, stats.documents, stats.bytes,
+                                             stats.readSeconds));
+        pipelineResults.push_back(makeResult("pipeline-score", t, stats.candidates, 0, stats.scoreSeconds));
+        for (size_t r = pipelineResults.size() - 3; r < pipelineResults.size(); ++r) {
+            pipelineResults[r].peakRssKiB = run.peakRssKiB;
+        }
+    }
+
+    // Single-thread stages run over the files held in memory, except the
+    // read stage, which maps each file and touches every byte
+    vector<string> texts;
+    uint64_t bytes = 0;
+    for (const string& name : files) {
+        ifstream in(name, ios::binary);
+        texts.emplace_back(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+        bytes += texts.back().size();
+    }
+
+    vector<Result> results;
+    uint64_t checksum = 0;
+    double seconds = fastest(reps, [&] {
+        for (const string& name : files) {
+            TextFile file;
+            if (!file.open(name)) continue;
+            const char* data;
+            size_t n;
+            while ((n = file.next(data)) > 0) {
+                for (size_t i = 0; i < n; ++i) checksum += static_cast<uint8_t>(data[i]);
+            }
+        }
+    });
+    results.push_back(makeResult("read", 1, files.size(), bytes, seconds));
+
+    size_t wordCount = 0;
+    seconds = fastest(reps, [&] {
+        Tokenizer tokenizer;
+        for (const string& text : texts) {
+            auto emit = [&](string_view) { wordCount++; };
+            tokenizer.feed(text.data(), text.size(), emit);
+            tokenizer.finish(emit);
+        }
+    });
+    results.push_back(makeResult("tokenize", 1, files.size(), bytes, seconds));
+
+    vector<TermVector> terms(texts.size());
+    seconds = fastest(reps, [&] {
+        Dictionary dictionary;
+        Tokenizer tokenizer;
+        TermCounter counter;
+        for (size_t d = 0; d < texts.size(); ++d) {
+            auto emit = [&](string_view word) { counter.add(dictionary.intern(word)); };
+            tokenizer.feed(texts[d].data(), texts[d].size(), emit);
+            tokenizer.finish(emit);
+            counter.finish(terms[d]);
+        }
+    });
+    results.push_back(makeResult("tokenize+count", 1, files.size(), bytes, seconds));
+
+    seconds = fastest(reps, [&] {
+        Tokenizer tokenizer;
+        MinHasher hasher;
+        Signature signature;
+        for (const string& text : texts) {
+            auto emit = [&](string_view word) { hasher.add(hashWord(word)); };
+            tokenizer.feed(text.data(), text.size(), emit);
+            tokenizer.finish(emit);
+            hasher.finish(signature);
+            checksum += signature.values[0];
+        }
+    });
+    results.push_back(makeResult("tokenize+minhash", 1, files.size(), bytes, seconds));
+
+    size_t scored = min(terms.size(), MAX_SCORED_DOCUMENTS);
+    double total = 0;
+    seconds = fastest(reps, [&] {
+        for (size_t a = 0; a < scored; ++a) {
+            for (size_t b = a + 1; b < scored; ++b) total += termSimilarity(terms[a], terms[b]);
+        }
+    });
+    results.push_back(makeResult("score", 1, scored * (scored - 1) / 2, 0, seconds));
+
+    results.insert(results.end(), pipelineResults.begin(), pipelineResults.end());
+
+    // Keeps the timed loops from being optimized away
+    if (checksum == 1 && wordCount == 1 && total < 0) cerr << "";
+
+    if (generated && !keep) {
+        error_code error;
+        filesystem::remove_all(directory, error);
+    }
+
+    if (json) {
+        printJson(results);
+    } else {
+        printCsv(results);
+    }
+    return ok ? 0 : 1;
+}
@@ -1,102 +1,303 @@
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <unordered_map>
+#include <cstdlib>
 #include <vector>
 #include <algorithm>
-#include <cctype>
+#include <string_view>
+#include "Tokenizer.h"
+#include "Dictionary.h"
+#include "TermVector.h"
+#include "MinHash.h"
+#include "Fingerprint.h"
+#include "Pipeline.h"
 
 using namespace std;
 
 
-string normalizeText(const string& str) {
-    string result;
-    for (char ch : str) {
-        if (isalnum(ch) || isspace(ch)) {
-            result += tolower(ch);
-        }
-    }
-    return result;
+// Function to turn a file into a term vector in a single pass over it,
+// interning its words into `dictionary`
+bool readTerms(const string& filename, Dictionary& dictionary, TermCounter& counter, TermVector& terms) {
+    bool ok = tokenizeFile(filename, [&](string_view word) {
+        counter.add(dictionary.intern(word));
+    });
+    counter.finish(terms);
+    return ok;
+}
+
+
+// Function to read a file once into both its term vector and its MinHash
+// signature over word shingles
+bool readDocument(const string& filename, Dictionary& dictionary, TermCounter& counter, MinHasher& hasher,
+                  TermVector& terms, Signature& signature) {
+    bool ok = tokenizeFile(filename, [&](string_view word) {
+        counter.add(dictionary.intern(word));
+        hasher.add(hashWord(word));
+    });
+    counter.finish(terms);
+    hasher.finish(signature);
+    return ok;
 }
 
 
-string readFile(const string& filename) {
-    ifstream file(filename);
-    if (!file.is_open()) {
-        cerr << "Error opening file: " << filename << endl;
-        return "";
+// Function to check each file against a corpus index and add it to the
+// index, replacing its entry if it was indexed before. Only LSH candidates
+// get the exact score, so a file costs one read plus a read of each
+// candidate, not a pass over the corpus. Prints pairs scoring at least
+// `threshold` percent; a file is never matched against its own entry.
+bool checkCorpus(const string& indexFile, const vector<string>& files, double threshold, Dictionary& dictionary) {
+    SignatureIndex index;
+    if (ifstream(indexFile).good() && !index.load(indexFile)) return false;
+    size_t corpusSize = index.size();
+
+    TermCounter counter;
+    MinHasher hasher;
+    TermVector terms;
+    Signature signature;
+    vector<uint32_t> candidates;
+    size_t candidateCount = 0;
+    size_t checked = 0;
+
+    // Term vectors of documents read in this run, by index id
+    unordered_map<uint32_t, TermVector> known;
+
+    for (const string& file : files) {
+        if (!readDocument(file, dictionary, counter, hasher, terms, signature) || terms.total == 0) {
+            cerr << "Skipping " << file << ": it could not be processed." << endl;
+            continue;
+        }
+
+        index.candidates(signature, candidates);
+        for (uint32_t id : candidates) {
+            if (index.name(id) == file) continue;
+            candidateCount++;
+            auto other = known.find(id);
+            if (other == known.end()) {
+                TermVector otherTerms;
+                if (!readTerms(index.name(id), dictionary, counter, otherTerms)) continue;
+                other = known.emplace(id, move(otherTerms)).first;
+            }
+
+            double similarity = termSimilarity(terms, other->second);
+            if (similarity >= threshold) {
+                cout << file << " ~ " << index.name(id) << ": " << similarity << "% (estimated shingle overlap "
+                     << estimateJaccard(signature, index.signature(id)) * 100 << "%)" << endl;
+            }
+        }
+
+        known[index.add(file, signature)] = terms;
+        checked++;
     }
 
-    stringstream buffer;
-    buffer << file.rdbuf();
-    file.close();
-    
-    return normalizeText(buffer.str());
+    cerr << "Checked " << checked << " documents against a corpus of " << corpusSize
+         << ", scoring " << candidateCount << " candidate pairs." << endl;
+    return index.save(indexFile);
+}
+
+
+// Function to read a file's winnowed fingerprints and the hash and byte
+// span of each of its words
+bool readFingerprints(const string& filename, Winnower& winnower, FingerprintedDocument& document) {
+    document.words.clear();
+    document.spans.clear();
+    bool ok = tokenizeFile(filename, [&](string_view word, uint64_t begin, uint64_t end) {
+        document.words.push_back(hashWord(word));
+        document.spans.push_back({ begin, end });
+        winnower.add(document.words.back());
+    });
+    winnower.finish(document.fingerprints);
+    return ok;
 }
 
 
-vector<string> splitText(const string& text) {
-    vector<string> words;
-    stringstream ss(text);
-    string word;
+// Function to report the passages each file shares with the files before
+// it, as word and byte ranges in both. Only regions of at least
+// WINNOW_GUARANTEE words count, and a pair is printed when they cover at
+// least `threshold` percent of the later file.
+bool checkFingerprints(const vector<string>& files, double threshold) {
+    FingerprintIndex index;
+    Winnower winnower;
+    FingerprintedDocument document;
+    vector<MatchRegion> regions;
+    bool ok = true;
 
-    while (ss >> word) {
-        words.push_back(word);
+    for (const string& file : files) {
+        if (!readFingerprints(file, winnower, document) || document.spans.empty()) {
+            cerr << "Skipping " << file << ": it could not be processed." << endl;
+            ok = false;
+            continue;
+        }
+
+        index.matches(document, regions);
+        regions.erase(remove_if(regions.begin(), regions.end(), [](const MatchRegion& region) {
+            return region.queryEnd - region.queryFirst < static_cast<uint32_t>(WINNOW_GUARANTEE);
+        }), regions.end());
+
+        for (size_t r = 0; r < regions.size();) {
+            uint32_t id = regions[r].document;
+            size_t end = r;
+            vector<bool> covered(document.spans.size(), false);
+            while (end < regions.size() && regions[end].document == id) {
+                fill(covered.begin() + regions[end].queryFirst, covered.begin() + regions[end].queryEnd, true);
+                end++;
+            }
+            double coverage = count(covered.begin(), covered.end(), true) * 100.0 / document.spans.size();
+
+            if (coverage >= threshold) {
+                const FingerprintedDocument& other = index.document(id);
+                cout << file << " ~ " << index.name(id) << ": " << end - r << " shared regions covering "
+                     << coverage << "% of " << file << endl;
+                for (size_t k = r; k < end; ++k) {
+                    const MatchRegion& region = regions[k];
+                    cout << "  words " << region.queryFirst << "-" << region.queryEnd
+                         << " (bytes " << document.spans[region.queryFirst].begin << "-"
+                         << document.spans[region.queryEnd - 1].end << ") ~ words "
+                         << region.otherFirst << "-" << region.otherEnd
+                         << " (bytes " << other.spans[region.otherFirst].begin << "-"
+                         << other.spans[region.otherEnd - 1].end << ")" << endl;
+                }
+            }
+            r = end;
+        }
+
+        index.add(file, move(document));
+        document = FingerprintedDocument();
     }
+    return ok;
+}
+
 
-    return words;
+void printUsage(const char* program) {
+    cerr << "Usage: " << program << " [-d <dictionary>] [file1 file2]" << endl;
+    cerr << "       " << program << " [-d <dictionary>] -i <index> [-t <percent>] <files...>" << endl;
+    cerr << "       " << program << " -w [-t <percent>] <files...>" << endl;
+    cerr << "       " << program << " [-d <dictionary>] -b [-j <threads>] [-a] [-t <percent>] [-f csv|json] [-l <list>] <files or directories...>" << endl;
+    cerr << "  -d  load the word dictionary from this file if it exists, and save it back" << endl;
+    cerr << "  -i  check the files against a corpus signature index, then add them to it" << endl;
+    cerr << "  -w  report the passages each file shares with the files before it" << endl;
+    cerr << "  -b  score every file against the others in a parallel batch, printing CSV or JSON" << endl;
+    cerr << "  -j  threads per batch stage (default, or 0: one per core)" << endl;
+    cerr << "  -a  score every pair in the batch, not only likely matches" << endl;
+    cerr << "  -l  also read the batch files from this list, one per line (- for stdin)" << endl;
+    cerr << "  -t  only report corpus matches scoring, or -w matches covering, at least this percentage" << endl;
+    cerr << "  without file names, asks for two" << endl;
 }
 
 
-double calculateSimilarity(const vector<string>& words1, const vector<string>& words2) {
-    unordered_map<string, int> wordCount1, wordCount2;
-    
-    for (const auto& word : words1) {
-        wordCount1[word]++;
-    }
-    for (const auto& word : words2) {
-        wordCount2[word]++;
+int main(int argc, char* argv[]) {
+    string file1, file2, dictionaryFile, indexFile;
+    double threshold = 0;
+    bool winnow = false;
+    bool batch = false;
+    string format = "csv";
+    BatchOptions options;
+    vector<string> lists;
+
+    vector<string> files;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "-d" && i + 1 < argc) {
+            dictionaryFile = argv[++i];
+        } else if (arg == "-i" && i + 1 < argc) {
+            indexFile = argv[++i];
+        } else if (arg == "-b") {
+            batch = true;
+        } else if (arg == "-j" && i + 1 < argc) {
+            int threads = atoi(argv[++i]);
+            if (threads < 0) {
+                printUsage(argv[0]);
+                return 1;
+            }
+            options.readers = options.scorers = threads;
+        } else if (arg == "-a") {
+            options.allPairs = true;
+        } else if (arg == "-l" && i + 1 < argc) {
+            lists.push_back(argv[++i]);
+        } else if (arg == "-f" && i + 1 < argc) {
+            format = argv[++i];
+        } else if (arg == "-w") {
+            winnow = true;
+        } else if (arg == "-t" && i + 1 < argc) {
+            threshold = atof(argv[++i]);
+        } else if (arg[0] != '-') {
+            files.push_back(arg);
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
     }
 
-    
-    double commonWordCount = 0;
-    for (const auto& entry : wordCount1) {
-        if (wordCount2.find(entry.first) != wordCount2.end()) {
-            commonWordCount += min(entry.second, wordCount2[entry.first]);
+    if (winnow) {
+        if (files.size() < 2 || !indexFile.empty()) {
+            printUsage(argv[0]);
+            return 1;
         }
+        return checkFingerprints(files, threshold) ? 0 : 1;
     }
 
-    
-    double totalWordCount = words1.size() + words2.size();
+    // A saved dictionary keeps word ids stable from run to run
+    Dictionary dictionary;
+    if (!dictionaryFile.empty() && ifstream(dictionaryFile).good() && !dictionary.load(dictionaryFile)) return 1;
 
-    
-    return (2 * commonWordCount / totalWordCount) * 100;
-}
+    if (batch) {
+        vector<string> batchFiles;
+        if (!indexFile.empty() || (format != "csv" && format != "json") || !collectFiles(files, lists, batchFiles)
+            || batchFiles.size() < 2) {
+            printUsage(argv[0]);
+            return 1;
+        }
 
-int main() {
-    string file1, file2;
+        options.threshold = threshold;
+        vector<BatchPair> pairs;
+        BatchStats stats;
+        bool ok = runBatch(batchFiles, options, dictionary, pairs, stats);
+        if (format == "json") {
+            writeBatchJson(cout, batchFiles, pairs, stats);
+        } else {
+            writeBatchCsv(cout, batchFiles, pairs);
+        }
+        printBatchStats(cerr, stats);
+        if (!dictionaryFile.empty() && !dictionary.save(dictionaryFile)) return 1;
+        return ok ? 0 : 1;
+    }
 
-    
-    cout << "Enter the first file name: ";
-    cin >> file1;
-    cout << "Enter the second file name: ";
-    cin >> file2;
+    if (!indexFile.empty()) {
+        if (files.empty()) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        if (!checkCorpus(indexFile, files, threshold, dictionary)) return 1;
+        return !dictionaryFile.empty() && !dictionary.save(dictionaryFile) ? 1 : 0;
+    }
+
+    if (files.size() == 2) {
+        file1 = files[0];
+        file2 = files[1];
+    } else if (files.empty()) {
+        cout << "Enter the first file name: ";
+        cin >> file1;
+        cout << "Enter the second file name: ";
+        cin >> file2;
+    } else {
+        printUsage(argv[0]);
+        return 1;
+    }
 
    
-    string content1 = readFile(file1);
-    string content2 = readFile(file2);
+    TermCounter counter;
+    TermVector terms1, terms2;
+    bool read1 = readTerms(file1, dictionary, counter, terms1);
+    bool read2 = readTerms(file2, dictionary, counter, terms2);
 
-    if (content1.empty() || content2.empty()) {
+    if (!read1 || !read2 || terms1.total == 0 || terms2.total == 0) {
         cerr << "One or both files could not be processed." << endl;
         return 1;
     }
 
-    
-    vector<string> words1 = splitText(content1);
-    vector<string> words2 = splitText(content2);
+    if (!dictionaryFile.empty() && !dictionary.save(dictionaryFile)) return 1;
 
     
-    double similarity = calculateSimilarity(words1, words2);
+    double similarity = termSimilarity(terms1, terms2);
 
    
     cout << "Similarity score between the two files: " << similarity << "%" << endl;
@@ -0,0 +1,181 @@
+#include "DancingLinks.h"
+
+DancingLinks::DancingLinks(int box)
+    : box(box), gridSize(box * box), cellCount(gridSize * gridSize), columnCount(4 * cellCount) {
+    int rows = cellCount * gridSize;
+    int nodes = 1 + columnCount + 4 * rows;
+    left.resize(nodes);
+    right.resize(nodes);
+    up.resize(nodes);
+    down.resize(nodes);
+    column.resize(nodes);
+    columnSize.assign(columnCount + 1, 0);
+
+    for (int c = 0; c <= columnCount; ++c) {
+        left[c] = c == 0 ? columnCount : c - 1;
+        right[c] = c == columnCount ? 0 : c + 1;
+        up[c] = down[c] = column[c] = c;
+    }
+
+    // Columns: cell filled, then digit in row, in column and in box
+    for (int r = 0; r < rows; ++r) {
+        int cell = r / gridSize, digit = r % gridSize;
+        int row = cell / gridSize, col = cell % gridSize;
+        int boxIndex = row / box * box + col / box;
+        int columns[4] = { 1 + cell, 1 + cellCount + row * gridSize + digit,
+                           1 + 2 * cellCount + col * gridSize + digit,
+                           1 + 3 * cellCount + boxIndex * gridSize + digit };
+
+        int base = 1 + columnCount + 4 * r;
+        for (int k = 0; k < 4; ++k) {
+            int n = base + k, c = columns[k];
+            column[n] = c;
+            up[n] = up[c];
+            down[n] = c;
+            down[up[c]] = n;
+            up[c] = n;
+            columnSize[c]++;
+            left[n] = base + (k + 3) % 4;
+            right[n] = base + (k + 1) % 4;
+        }
+    }
+
+    grid.assign(cellCount, 0);
+    firstSolution.assign(cellCount, 0);
+    rowUsed.assign(gridSize, 0);
+    colUsed.assign(gridSize, 0);
+    boxUsed.assign(gridSize, 0);
+}
+
+// Function to take a column and every row that meets it out of the matrix
+void DancingLinks::cover(int c) {
+    right[left[c]] = right[c];
+    left[right[c]] = left[c];
+    for (int i = down[c]; i != c; i = down[i]) {
+        for (int j = right[i]; j != i; j = right[j]) {
+            up[down[j]] = up[j];
+            down[up[j]] = down[j];
+            columnSize[column[j]]--;
+        }
+    }
+}
+
+// Function to undo cover(c); calls must come in the reverse order
+void DancingLinks::uncover(int c) {
+    for (int i = up[c]; i != c; i = up[i]) {
+        for (int j = left[i]; j != i; j = left[j]) {
+            columnSize[column[j]]++;
+            up[down[j]] = j;
+            down[up[j]] = j;
+        }
+    }
+    right[left[c]] = c;
+    left[right[c]] = c;
+}
+
+void DancingLinks::clear() {
+    while (chosen.size() > 0) {
+        int base = 1 + columnCount + 4 * chosen.back();
+        chosen.pop_back();
+        for (int k = 3; k >= 0; --k) uncover(column[base + k]);
+    }
+    givenCount = 0;
+    grid.assign(cellCount, 0);
+    rowUsed.assign(gridSize, 0);
+    colUsed.assign(gridSize, 0);
+    boxUsed.assign(gridSize, 0);
+    guessCount = 0;
+}
+
+bool DancingLinks::placeGiven(int cell, int value) {
+    int row = cell / gridSize, col = cell % gridSize;
+    int boxIndex = row / box * box + col / box;
+    uint32_t bit = 1u << (value - 1);
+    // Givens that clash would cover a column twice, so they are caught here
+    if ((rowUsed[row] | colUsed[col] | boxUsed[boxIndex]) & bit) return false;
+    rowUsed[row] |= bit;
+    colUsed[col] |= bit;
+    boxUsed[boxIndex] |= bit;
+    grid[cell] = value;
+
+    int r = cell * gridSize + value - 1;
+    int base = 1 + columnCount + 4 * r;
+    for (int k = 0; k < 4; ++k) cover(column[base + k]);
+    chosen.push_back(r);
+    givenCount = chosen.size();
+    return true;
+}
+
+bool DancingLinks::load(const vector<vector<int>>& board) {
+    clear();
+    if (board.size() != static_cast<size_t>(gridSize)) return false;
+    for (const vector<int>& row : board) {
+        if (row.size() != static_cast<size_t>(gridSize)) return false;
+    }
+    for (int cell = 0; cell < cellCount; ++cell) {
+        int value = board[cell / gridSize][cell % gridSize];
+        if (value == 0) continue;
+        if (value < 0 || value > gridSize || !placeGiven(cell, value)) return false;
+    }
+    return true;
+}
+
+bool DancingLinks::load(const char* line, size_t length) {
+    clear();
+    if (length != static_cast<size_t>(cellCount)) return false;
+    for (int cell = 0; cell < cellCount; ++cell) {
+        int value = sudokuDigit(line[cell]);
+        if (value == 0) continue;
+        if (value < 0 || value > gridSize || !placeGiven(cell, value)) return false;
+    }
+    return true;
+}
+
+void DancingLinks::store(vector<vector<int>>& board) const {
+    board.assign(gridSize, vector<int>(gridSize, 0));
+    for (int cell = 0; cell < cellCount; ++cell) board[cell / gridSize][cell % gridSize] = grid[cell];
+}
+
+void DancingLinks::search(int limit, int& found) {
+    if (right[0] == 0) {
+        if (found++ == 0) {
+            for (int cell = 0; cell < cellCount; ++cell) firstSolution[cell] = grid[cell];
+            for (size_t i = givenCount; i < chosen.size(); ++i) {
+                firstSolution[chosen[i] / gridSize] = chosen[i] % gridSize + 1;
+            }
+        }
+        return;
+    }
+
+    int best = right[0];
+    for (int c = right[best]; c != 0 && columnSize[best] > 1; c = right[c]) {
+        if (columnSize[c] < columnSize[best]) best = c;
+    }
+    if (columnSize[best] == 0) return;
+
+    bool guessing = columnSize[best] > 1;
+    cover(best);
+    for (int r = down[best]; r != best && found < limit; r = down[r]) {
+        if (guessing) guessCount++;
+        chosen.push_back((r - 1 - columnCount) / 4);
+        for (int j = right[r]; j != r; j = right[j]) cover(column[j]);
+        search(limit, found);
+        for (int j = left[r]; j != r; j = left[j]) uncover(column[j]);
+        chosen.pop_back();
+    }
+    uncover(best);
+}
+
+bool DancingLinks::solve() {
+    int found = 0;
+    search(1, found);
+    if (found == 0) return false;
+    grid = firstSolution;
+    return true;
+}
+
+int DancingLinks::countSolutions(int limit) {
+    int found = 0;
+    search(limit, found);
+    return found;
+}
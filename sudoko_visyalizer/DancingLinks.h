@@ -0,0 +1,81 @@
+#ifndef DANCINGLINKS_H
+#define DANCINGLINKS_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "SudokuSolver.h"
+
+using namespace std;
+
+// Exact-cover Sudoku backend (Knuth's Algorithm X on dancing links) for
+// (box*box)x(box*box) grids. Each of the size^3 (cell, digit) choices is a
+// row covering four columns: the cell is filled, and its row, column and
+// box hold the digit. The search always branches on the column with the
+// fewest rows left, so a cell with one candidate and a digit with one place
+// in a unit are forced without any separate propagation pass, which keeps
+// the cost per guess flat on 16x16 and 25x25 grids.
+//
+// The matrix is built once in the constructor. Loading a puzzle covers the
+// givens' rows and every search puts back what it took, so one solver is
+// reused for any number of puzzles of its size. The interface matches
+// BasicSudokuSolver's.
+class DancingLinks {
+public:
+    explicit DancingLinks(int box);
+
+    // Function to set the puzzle from a size x size board with 0 for empty
+    // cells; false if the board is the wrong size or the givens already
+    // break a rule
+    bool load(const vector<vector<int>>& board);
+
+    // Function to set the puzzle from the line format, size*size characters
+    // row by row as read by sudokuDigit(); false if the line is malformed
+    // or the givens break a rule
+    bool load(const char* line, size_t length);
+
+    // Function to solve the loaded puzzle; false if it has no solution, in
+    // which case the grid is back to the givens
+    bool solve();
+
+    // Function to count the solutions of the loaded puzzle, stopping at
+    // `limit`. The grid is left at the givens; the first solution found is
+    // kept, see solution().
+    int countSolutions(int limit = 2);
+
+    // Function to write the grid (solved or not) back to a size x size board
+    void store(vector<vector<int>>& board) const;
+
+    int size() const { return gridSize; }
+    int cells() const { return cellCount; }
+    int value(int cell) const { return grid[cell]; }
+    int solution(int cell) const { return firstSolution[cell]; }
+    uint64_t guesses() const { return guessCount; }
+
+private:
+    void clear();
+    bool placeGiven(int cell, int value);
+    void cover(int column);
+    void uncover(int column);
+    void search(int limit, int& found);
+
+    int box;
+    int gridSize;
+    int cellCount;
+    int columnCount;
+
+    // Node 0 is the root, nodes 1..columnCount the column headers, then four
+    // nodes per matrix row in one block; a node's matrix row is its offset
+    // in that block divided by four
+    vector<int> left, right, up, down, column;
+    vector<int> columnSize;
+
+    vector<uint8_t> grid;
+    vector<uint8_t> firstSolution;
+    vector<int> chosen;     // matrix rows picked so far (givens first)
+    size_t givenCount = 0;
+    vector<uint32_t> rowUsed, colUsed, boxUsed;
+    uint64_t guessCount = 0;
+};
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef STEPRING_H
+#define STEPRING_H
+
+#include <atomic>
+#include <cstddef>
+
+using namespace std;
+
+// Lock-free single-producer, single-consumer ring of CAPACITY items (a
+// power of two). The producer only writes `tail` and the consumer only
+// writes `head`, each publishing its side with a release store, so neither
+// ever waits on a lock; a full ring makes push() fail instead of blocking.
+template <typename T, size_t CAPACITY>
+class StepRing {
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "capacity must be a power of two");
+
+public:
+    // Function to append one item (producer only); false if the ring is full
+    bool push(const T& item) {
+        size_t t = tail.load(memory_order_relaxed);
+        if (t - head.load(memory_order_acquire) == CAPACITY) return false;
+        items[t & (CAPACITY - 1)] = item;
+        tail.store(t + 1, memory_order_release);
+        return true;
+    }
+
+    // Function to move up to `max` of the oldest items to `out` (consumer
+    // only), returning how many were taken
+    size_t pop(T* out, size_t max) {
+        size_t h = head.load(memory_order_relaxed);
+        size_t available = tail.load(memory_order_acquire) - h;
+        size_t n = available < max ? available : max;
+        for (size_t i = 0; i < n; ++i) out[i] = items[(h + i) & (CAPACITY - 1)];
+        head.store(h + n, memory_order_release);
+        return n;
+    }
+
+private:
+    T items[CAPACITY];
+    // On separate cache lines so the two threads do not contend for one
+    alignas(64) atomic<size_t> head{ 0 };
+    alignas(64) atomic<size_t> tail{ 0 };
+};
+
+#endif
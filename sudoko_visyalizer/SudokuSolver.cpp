@@ -0,0 +1,277 @@
+#include "SudokuSolver.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+static int popcount(uint32_t bits) {
+#ifdef _MSC_VER
+    return __popcnt(bits);
+#else
+    return __builtin_popcount(bits);
+#endif
+}
+
+static int lowestDigit(uint32_t bits) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, bits);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(bits);
+#endif
+}
+
+// Row, column and box of every cell, and the cells of every unit
+template <int BOX>
+struct SudokuTables {
+    static const int SIZE = BOX * BOX;
+    static const int CELLS = SIZE * SIZE;
+
+    uint8_t row[CELLS];
+    uint8_t col[CELLS];
+    uint8_t box[CELLS];
+    uint16_t units[3 * SIZE][SIZE];
+
+    SudokuTables() {
+        for (int cell = 0; cell < CELLS; ++cell) {
+            row[cell] = cell / SIZE;
+            col[cell] = cell % SIZE;
+            box[cell] = row[cell] / BOX * BOX + col[cell] / BOX;
+        }
+        int filled[3 * SIZE] = {};
+        for (int cell = 0; cell < CELLS; ++cell) {
+            int unit[3] = { row[cell], SIZE + col[cell], 2 * SIZE + box[cell] };
+            for (int u : unit) units[u][filled[u]++] = cell;
+        }
+    }
+};
+
+template <int BOX>
+static const SudokuTables<BOX>& tables() {
+    static const SudokuTables<BOX> t;
+    return t;
+}
+
+// Mask with one bit for each digit of a unit
+template <int BOX>
+static typename BasicSudokuSolver<BOX>::Mask allDigits() {
+    return static_cast<typename BasicSudokuSolver<BOX>::Mask>((1u << (BOX * BOX)) - 1);
+}
+
+template <int BOX>
+void BasicSudokuSolver<BOX>::clear() {
+    for (int cell = 0; cell < CELLS; ++cell) grid[cell] = 0;
+    for (int i = 0; i < SIZE; ++i) rowMask[i] = colMask[i] = boxMask[i] = 0;
+    trail.clear();
+    guessCount = 0;
+}
+
+template <int BOX>
+bool BasicSudokuSolver<BOX>::placeGiven(int cell, int value) {
+    const SudokuTables<BOX>& t = tables<BOX>();
+    Mask bit = 1 << (value - 1);
+    if ((rowMask[t.row[cell]] | colMask[t.col[cell]] | boxMask[t.box[cell]]) & bit) return false;
+    grid[cell] = value;
+    rowMask[t.row[cell]] |= bit;
+    colMask[t.col[cell]] |= bit;
+    boxMask[t.box[cell]] |= bit;
+    return true;
+}
+
+template <int BOX>
+bool BasicSudokuSolver<BOX>::load(const vector<vector<int>>& board) {
+    clear();
+    if (board.size() != static_cast<size_t>(SIZE)) return false;
+    for (const vector<int>& row : board) {
+        if (row.size() != static_cast<size_t>(SIZE)) return false;
+    }
+    for (int cell = 0; cell < CELLS; ++cell) {
+        int value = board[cell / SIZE][cell % SIZE];
+        if (value == 0) continue;
+        if (value < 0 || value > SIZE || !placeGiven(cell, value)) return false;
+    }
+    return true;
+}
+
+template <int BOX>
+bool BasicSudokuSolver<BOX>::load(const char* line, size_t length) {
+    clear();
+    if (length != static_cast<size_t>(CELLS)) return false;
+    for (int cell = 0; cell < CELLS; ++cell) {
+        int value = sudokuDigit(line[cell]);
+        if (value == 0) continue;
+        if (value < 0 || value > SIZE || !placeGiven(cell, value)) return false;
+    }
+    return true;
+}
+
+template <int BOX>
+void BasicSudokuSolver<BOX>::store(vector<vector<int>>& board) const {
+    board.assign(SIZE, vector<int>(SIZE, 0));
+    for (int cell = 0; cell < CELLS; ++cell) board[cell / SIZE][cell % SIZE] = grid[cell];
+}
+
+template <int BOX>
+typename BasicSudokuSolver<BOX>::Mask BasicSudokuSolver<BOX>::candidates(int cell) const {
+    const SudokuTables<BOX>& t = tables<BOX>();
+    return allDigits<BOX>() & ~(rowMask[t.row[cell]] | colMask[t.col[cell]] | boxMask[t.box[cell]]);
+}
+
+template <int BOX>
+void BasicSudokuSolver<BOX>::place(int cell, int digit) {
+    const SudokuTables<BOX>& t = tables<BOX>();
+    Mask bit = 1 << digit;
+    grid[cell] = digit + 1;
+    rowMask[t.row[cell]] |= bit;
+    colMask[t.col[cell]] |= bit;
+    boxMask[t.box[cell]] |= bit;
+    trail.push_back(cell);
+    if (observer) observer(cell, digit + 1);
+}
+
+template <int BOX>
+void BasicSudokuSolver<BOX>::undoTo(size_t mark) {
+    const SudokuTables<BOX>& t = tables<BOX>();
+    while (trail.size() > mark) {
+        int cell = trail.back();
+        trail.pop_back();
+        Mask bit = ~(1 << (grid[cell] - 1));
+        rowMask[t.row[cell]] &= bit;
+        colMask[t.col[cell]] &= bit;
+        boxMask[t.box[cell]] &= bit;
+        grid[cell] = 0;
+        if (observer) observer(cell, 0);
+    }
+}
+
+// Function to fill forced cells until none are left; false on a
+// contradiction (a cell with no candidate, or a digit with no place in a
+// unit)
+template <int BOX>
+bool BasicSudokuSolver<BOX>::propagate() {
+    const SudokuTables<BOX>& t = tables<BOX>();
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        for (int cell = 0; cell < CELLS; ++cell) {
+            if (grid[cell] != 0) continue;
+            Mask options = candidates(cell);
+            if (options == 0) return false;
+            if ((options & (options - 1)) == 0) {
+                place(cell, lowestDigit(options));
+                changed = true;
+            }
+        }
+
+        for (int u = 0; u < UNITS; ++u) {
+            // Digits that are candidates in at least one and in at least
+            // two of the unit's empty cells
+            Mask once = 0, twice = 0, used = 0;
+            for (int cell : t.units[u]) {
+                if (grid[cell] != 0) {
+                    used |= 1 << (grid[cell] - 1);
+                } else {
+                    Mask options = candidates(cell);
+                    twice |= once & options;
+                    once |= options;
+                }
+            }
+            if ((once | used) != allDigits<BOX>()) return false;
+
+            for (Mask singles = once & ~twice; singles != 0; singles &= singles - 1) {
+                Mask bit = singles & -singles;
+                int target = -1;
+                for (int cell : t.units[u]) {
+                    if (grid[cell] == 0 && (candidates(cell) & bit)) target = cell;
+                }
+                // An earlier single may have taken the cell or the digit
+                if (target < 0) return false;
+                place(target, lowestDigit(bit));
+                changed = true;
+            }
+        }
+    }
+    return true;
+}
+
+// Function to return the empty cell with the fewest candidates, -1 if the
+// grid is full. After propagation no cell has a single candidate, so the
+// scan stops at the first one with two.
+template <int BOX>
+int BasicSudokuSolver<BOX>::pickCell() const {
+    int best = -1, bestCount = SIZE + 1;
+    for (int cell = 0; cell < CELLS && bestCount > 2; ++cell) {
+        if (grid[cell] != 0) continue;
+        int count = popcount(candidates(cell));
+        if (count < bestCount) {
+            best = cell;
+            bestCount = count;
+        }
+    }
+    return best;
+}
+
+template <int BOX>
+bool BasicSudokuSolver<BOX>::search() {
+    size_t mark = trail.size();
+    if (!propagate()) {
+        undoTo(mark);
+        return false;
+    }
+
+    int best = pickCell();
+    if (best < 0) return true;
+
+    for (Mask options = candidates(best); options != 0; options &= options - 1) {
+        size_t guess = trail.size();
+        guessCount++;
+        place(best, lowestDigit(options));
+        if (search()) return true;
+        undoTo(guess);
+    }
+    undoTo(mark);
+    return false;
+}
+
+template <int BOX>
+bool BasicSudokuSolver<BOX>::solve() {
+    return search();
+}
+
+template <int BOX>
+void BasicSudokuSolver<BOX>::count(int limit, int& found) {
+    size_t mark = trail.size();
+    if (!propagate()) {
+        undoTo(mark);
+        return;
+    }
+
+    int best = pickCell();
+    if (best < 0) {
+        if (found++ == 0) {
+            for (int cell = 0; cell < CELLS; ++cell) firstSolution[cell] = grid[cell];
+        }
+    } else {
+        for (Mask options = candidates(best); options != 0 && found < limit; options &= options - 1) {
+            size_t guess = trail.size();
+            guessCount++;
+            place(best, lowestDigit(options));
+            count(limit, found);
+            undoTo(guess);
+        }
+    }
+    undoTo(mark);
+}
+
+template <int BOX>
+int BasicSudokuSolver<BOX>::countSolutions(int limit) {
+    int found = 0;
+    count(limit, found);
+    return found;
+}
+
+template class BasicSudokuSolver<3>;
+template class BasicSudokuSolver<4>;
+template class BasicSudokuSolver<5>;
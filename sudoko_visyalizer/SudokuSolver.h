@@ -0,0 +1,114 @@
+#ifndef SUDOKUSOLVER_H
+#define SUDOKUSOLVER_H
+
+#include <vector>
+#include <functional>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+const int SUDOKU_SIZE = 9;
+const int SUDOKU_CELLS = SUDOKU_SIZE * SUDOKU_SIZE;
+const int SUDOKU_UNITS = 3 * SUDOKU_SIZE; // rows, columns and boxes
+
+// Largest box size the solvers are built for (25x25 grids)
+const int SUDOKU_MAX_BOX = 5;
+
+// Function to read one cell of the line format: 0 for an empty cell
+// ('0' or '.'), the digit for '1'-'9' and 10 onwards for 'A'-'P' (either
+// case), e.g. 'G' is 16; -1 for anything else
+inline int sudokuDigit(char c) {
+    if (c == '0' || c == '.') return 0;
+    if (c >= '1' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'P') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'p') return c - 'a' + 10;
+    return -1;
+}
+
+// Function to write one cell in the line format, '.' for an empty cell
+inline char sudokuSymbol(int value) {
+    if (value == 0) return '.';
+    return static_cast<char>(value <= 9 ? '0' + value : 'A' + value - 10);
+}
+
+// Constraint-propagation Sudoku solver for (BOX*BOX)x(BOX*BOX) grids. The
+// grid is a flat array of cells; each row, column and box keeps a mask of
+// the digits it holds, so a cell's candidates are one OR and one NOT away.
+// Before every guess it fills naked singles (cells with one candidate) and
+// hidden singles (digits with one place left in a unit), then branches on
+// the cell with the fewest candidates. Every placement goes on a trail, so
+// backtracking undoes exactly what a failed guess caused.
+//
+// The box size is a template argument, so the masks are the narrowest
+// integer that holds a unit's digits and every loop has a constant trip
+// count the compiler can unroll. SudokuSolver.cpp instantiates boxes 3 to
+// SUDOKU_MAX_BOX; DancingLinks.h is the exact-cover backend for the larger
+// grids.
+template <int BOX>
+class BasicSudokuSolver {
+public:
+    static const int SIZE = BOX * BOX;
+    static const int CELLS = SIZE * SIZE;
+    static const int UNITS = 3 * SIZE;
+    typedef typename conditional<(SIZE <= 16), uint16_t, uint32_t>::type Mask;
+
+    // Called with (cell, digit) for each placement and (cell, 0) for each
+    // undo, in order, e.g. to animate the search
+    typedef function<void(int cell, int value)> Observer;
+
+    // Function to set the puzzle from a SIZE x SIZE board with 0 for empty
+    // cells; false if the board is the wrong size or the givens already
+    // break a rule
+    bool load(const vector<vector<int>>& board);
+
+    // Function to set the puzzle from the line format, CELLS characters
+    // row by row as read by sudokuDigit(); false if the line is malformed
+    // or the givens break a rule
+    bool load(const char* line, size_t length);
+
+    // Function to solve the loaded puzzle in place; false if it has no
+    // solution, in which case the grid is back to the givens
+    bool solve();
+
+    // Function to count the solutions of the loaded puzzle, stopping at
+    // `limit` (2 is enough to tell a unique solution from several). The
+    // grid is left at the givens; the first solution found is kept, see
+    // solution().
+    int countSolutions(int limit = 2);
+
+    // Function to write the grid (solved or not) back to a SIZE x SIZE board
+    void store(vector<vector<int>>& board) const;
+
+    int cells() const { return CELLS; }
+    int value(int cell) const { return grid[cell]; }
+    int solution(int cell) const { return firstSolution[cell]; }
+    uint64_t guesses() const { return guessCount; }
+    void setObserver(Observer observer) { this->observer = observer; }
+
+private:
+    void clear();
+    Mask candidates(int cell) const;
+    void place(int cell, int digit);
+    void undoTo(size_t mark);
+    bool propagate();
+    int pickCell() const;
+    bool search();
+    void count(int limit, int& found);
+    bool placeGiven(int cell, int value);
+
+    uint8_t grid[CELLS] = {};
+    uint8_t firstSolution[CELLS] = {};
+    Mask rowMask[SIZE] = {};
+    Mask colMask[SIZE] = {};
+    Mask boxMask[SIZE] = {};
+    vector<uint16_t> trail;
+    uint64_t guessCount = 0;
+    Observer observer;
+};
+
+// The classic 9x9 solver used by the visualizer and the board viewer
+typedef BasicSudokuSolver<3> SudokuSolver;
+
+#endif
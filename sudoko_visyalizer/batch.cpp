@@ -0,0 +1,322 @@
+// Headless batch solver for validating puzzle packs: reads puzzles in the
+// one-line-per-puzzle format, solves them on a pool of worker threads (each
+// with its own solvers) and prints one result line per puzzle, in input
+// order, then throughput and latency percentiles on stderr. A line of 81,
+// 256 or 625 cells is a 9x9, 16x16 or 25x25 puzzle; sizes can be mixed.
+//
+// Build:
+//   g++ -O2 -std=c++11 -pthread batch.cpp SudokuSolver.cpp DancingLinks.cpp -o sudoku_batch
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <memory>
+#include <cstdlib>
+#include "SudokuSolver.h"
+#include "DancingLinks.h"
+
+using namespace std;
+
+// Puzzles read and solved at a time, so memory stays bounded on huge packs
+const size_t BATCH_PUZZLES = 1 << 16;
+// Puzzles a worker takes from the batch at once
+const size_t WORKER_CHUNK = 64;
+
+enum Outcome {
+    OUTCOME_SOLVED,
+    OUTCOME_UNIQUE,
+    OUTCOME_MULTIPLE,
+    OUTCOME_UNSOLVABLE,
+    OUTCOME_INVALID
+};
+
+enum Backend {
+    BACKEND_AUTO,     // bitmask for 9x9, dancing links for larger grids
+    BACKEND_BITMASK,
+    BACKEND_LINKS
+};
+
+struct Puzzle {
+    string line;
+    string solution;
+    Outcome outcome = OUTCOME_INVALID;
+    double micros = 0;
+};
+
+static double now() {
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// One solver of each kind and size per worker, the dancing-links ones
+// built on first use since their matrices are the largest
+struct Solvers {
+    BasicSudokuSolver<3> bitmask9;
+    BasicSudokuSolver<4> bitmask16;
+    BasicSudokuSolver<5> bitmask25;
+    unique_ptr<DancingLinks> links[SUDOKU_MAX_BOX + 1];
+
+    DancingLinks& linksFor(int box) {
+        if (!links[box]) links[box].reset(new DancingLinks(box));
+        return *links[box];
+    }
+};
+
+template <typename Solver>
+static void runSolver(Solver& solver, Puzzle& puzzle, bool checkUnique) {
+    const string& line = puzzle.line;
+    if (!solver.load(line.data(), line.size())) {
+        puzzle.outcome = OUTCOME_INVALID;
+    } else if (checkUnique) {
+        int solutions = solver.countSolutions(2);
+        puzzle.outcome = solutions == 0 ? OUTCOME_UNSOLVABLE : solutions == 1 ? OUTCOME_UNIQUE : OUTCOME_MULTIPLE;
+        if (solutions > 0) {
+            for (int cell = 0; cell < solver.cells(); ++cell) puzzle.solution += sudokuSymbol(solver.solution(cell));
+        }
+    } else if (solver.solve()) {
+        puzzle.outcome = OUTCOME_SOLVED;
+        for (int cell = 0; cell < solver.cells(); ++cell) puzzle.solution += sudokuSymbol(solver.value(cell));
+    } else {
+        puzzle.outcome = OUTCOME_UNSOLVABLE;
+    }
+}
+
+// Function to solve one puzzle with the backend for its size
+static void solvePuzzle(Solvers& solvers, Puzzle& puzzle, Backend backend, bool checkUnique) {
+    double start = now();
+    const string& line = puzzle.line;
+    puzzle.solution.clear();
+    int box = 0;
+    for (int b = 3; b <= SUDOKU_MAX_BOX; ++b) {
+        if (line.size() == static_cast<size_t>(b * b * b * b)) box = b;
+    }
+
+    if (box == 0) {
+        puzzle.outcome = OUTCOME_INVALID;
+    } else if (backend == BACKEND_LINKS || (backend == BACKEND_AUTO && box > 3)) {
+        runSolver(solvers.linksFor(box), puzzle, checkUnique);
+    } else if (box == 3) {
+        runSolver(solvers.bitmask9, puzzle, checkUnique);
+    } else if (box == 4) {
+        runSolver(solvers.bitmask16, puzzle, checkUnique);
+    } else {
+        runSolver(solvers.bitmask25, puzzle, checkUnique);
+    }
+    puzzle.micros = (now() - start) * 1e6;
+}
+
+// Fixed set of workers that solve one batch at a time. Each worker keeps
+// its solvers (and their buffers) for the whole run and takes puzzles
+// from the batch in chunks through one atomic counter.
+class SolverPool {
+public:
+    SolverPool(unsigned threads, Backend backend, bool checkUnique) : backend(backend), checkUnique(checkUnique) {
+        for (unsigned t = 0; t < threads; ++t) workers.emplace_back([this] { work(); });
+    }
+
+    ~SolverPool() {
+        {
+            lock_guard<mutex> lock(guard);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (thread& worker : workers) worker.join();
+    }
+
+    // Function to solve the first `count` puzzles, returning when all are done
+    void solve(vector<Puzzle>& puzzles, size_t count) {
+        unique_lock<mutex> lock(guard);
+        batch = &puzzles;
+        batchSize = count;
+        next = 0;
+        active = workers.size();
+        generation++;
+        wake.notify_all();
+        done.wait(lock, [this] { return active == 0; });
+        batch = nullptr;
+    }
+
+private:
+    void work() {
+        Solvers solvers;
+        uint64_t seen = 0;
+        while (true) {
+            vector<Puzzle>* puzzles;
+            size_t count;
+            {
+                unique_lock<mutex> lock(guard);
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+                puzzles = batch;
+                count = batchSize;
+            }
+
+            size_t start;
+            while ((start = next.fetch_add(WORKER_CHUNK)) < count) {
+                size_t end = min(count, start + WORKER_CHUNK);
+                for (size_t i = start; i < end; ++i) solvePuzzle(solvers, (*puzzles)[i], backend, checkUnique);
+            }
+
+            lock_guard<mutex> lock(guard);
+            if (--active == 0) done.notify_one();
+        }
+    }
+
+    Backend backend;
+    bool checkUnique;
+    vector<thread> workers;
+    mutex guard;
+    condition_variable wake;
+    condition_variable done;
+    vector<Puzzle>* batch = nullptr;
+    size_t batchSize = 0;
+    atomic<size_t> next{ 0 };
+    size_t active = 0;
+    uint64_t generation = 0;
+    bool stopping = false;
+};
+
+static const char* outcomeName(Outcome outcome) {
+    switch (outcome) {
+    case OUTCOME_SOLVED: return "solved";
+    case OUTCOME_UNIQUE: return "unique";
+    case OUTCOME_MULTIPLE: return "multiple";
+    case OUTCOME_UNSOLVABLE: return "unsolvable";
+    default: return "invalid";
+    }
+}
+
+static double percentile(const vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t index = static_cast<size_t>(p / 100 * (sorted.size() - 1) + 0.5);
+    return sorted[index];
+}
+
+static void printUsage(const char* program) {
+    cerr << "Usage: " << program << " [-j <threads>] [-e auto|bitmask|dlx] [-u] [-q] [puzzles.txt|-]..." << endl;
+    cerr << "  reads one puzzle per line, from each file in turn or stdin: 81, 256 or 625 cells row by row, 1-9 then A-P for givens," << endl;
+    cerr << "  0 or . for empty" << endl;
+    cerr << "  -j  worker threads (default: one per core)" << endl;
+    cerr << "  -e  solver: bitmask propagation, dancing links, or auto (bitmask for 9x9 only)" << endl;
+    cerr << "  -u  check that each puzzle has exactly one solution, stopping at the second" << endl;
+    cerr << "  -q  print only the summary" << endl;
+    cerr << "  exits with 2 if any puzzle is invalid, unsolvable or, with -u, not unique" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    unsigned threads = max(1u, thread::hardware_concurrency());
+    Backend backend = BACKEND_AUTO;
+    bool checkUnique = false;
+    bool quiet = false;
+    vector<string> inputs;
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "-j" && i + 1 < argc) {
+            threads = max(1, atoi(argv[++i]));
+        } else if (arg == "-e" && i + 1 < argc) {
+            string name = argv[++i];
+            if (name == "auto") {
+                backend = BACKEND_AUTO;
+            } else if (name == "bitmask") {
+                backend = BACKEND_BITMASK;
+            } else if (name == "dlx") {
+                backend = BACKEND_LINKS;
+            } else {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "-u") {
+            checkUnique = true;
+        } else if (arg == "-q") {
+            quiet = true;
+        } else if (arg == "-" || arg[0] != '-') {
+            inputs.push_back(arg);
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    // Check every file up front, so a bad name fails before any output
+    if (inputs.empty()) inputs.push_back("-");
+    for (const string& input : inputs) {
+        if (input != "-" && !ifstream(input).is_open()) {
+            cerr << "Error opening file: " << input << endl;
+            return 1;
+        }
+    }
+    ios::sync_with_stdio(false);
+
+    SolverPool pool(threads, backend, checkUnique);
+    vector<Puzzle> batch(BATCH_PUZZLES);
+    vector<double> latencies;
+    size_t counts[OUTCOME_INVALID + 1] = {};
+    double solveSeconds = 0;
+    double start = now();
+
+    // Batches run across file boundaries, so many small files still fill them
+    size_t current = 0;
+    ifstream file;
+    while (current < inputs.size()) {
+        size_t filled = 0;
+        while (filled < BATCH_PUZZLES && current < inputs.size()) {
+            if (inputs[current] != "-" && !file.is_open()) {
+                file.open(inputs[current]);
+                if (!file.is_open()) {
+                    cerr << "Error opening file: " << inputs[current] << endl;
+                    return 1;
+                }
+            }
+            istream& in = inputs[current] == "-" ? cin : file;
+            if (!getline(in, batch[filled].line)) {
+                file.close();
+                file.clear();
+                current++;
+                continue;
+            }
+            // Strip CRLF endings first, so a blank line in a Windows pack
+            // is skipped rather than read as an empty puzzle
+            string& line = batch[filled].line;
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (!line.empty()) filled++;
+        }
+        if (filled == 0) break;
+
+        double begin = now();
+        pool.solve(batch, filled);
+        solveSeconds += now() - begin;
+
+        for (size_t i = 0; i < filled; ++i) {
+            const Puzzle& puzzle = batch[i];
+            counts[puzzle.outcome]++;
+            latencies.push_back(puzzle.micros);
+            if (quiet) continue;
+            cout << (puzzle.solution.empty() ? puzzle.line : puzzle.solution) << ' ' << outcomeName(puzzle.outcome)
+                 << '\n';
+        }
+    }
+    cout.flush();
+    double seconds = now() - start;
+
+    sort(latencies.begin(), latencies.end());
+    size_t total = latencies.size();
+    cerr << total << " puzzles on " << threads << " threads in " << seconds << " s: "
+         << (solveSeconds > 0 ? total / solveSeconds : 0) << " puzzles/s solving, "
+         << (seconds > 0 ? total / seconds : 0) << " puzzles/s overall" << endl;
+    cerr << "Latency (us): p50 " << percentile(latencies, 50) << ", p90 " << percentile(latencies, 90) << ", p99 "
+         << percentile(latencies, 99) << ", max " << (total > 0 ? latencies.back() : 0) << endl;
+    cerr << "Solved " << counts[OUTCOME_SOLVED] + counts[OUTCOME_UNIQUE] + counts[OUTCOME_MULTIPLE];
+    if (checkUnique) cerr << " (" << counts[OUTCOME_UNIQUE] << " unique, " << counts[OUTCOME_MULTIPLE] << " multiple)";
+    cerr << ", unsolvable " << counts[OUTCOME_UNSOLVABLE] << ", invalid " << counts[OUTCOME_INVALID] << endl;
+
+    bool allGood = counts[OUTCOME_UNSOLVABLE] == 0 && counts[OUTCOME_INVALID] == 0 && counts[OUTCOME_MULTIPLE] == 0;
+    return allGood ? 0 : 2;
+}
@@ -1,43 +1,21 @@
 #include <SFML/Graphics.hpp>
 #include <vector>
 #include <iostream>
+#include "SudokuSolver.h"
 
 using namespace std;
 using namespace sf;
 
 #define N 9
 
-bool isSafe(vector<vector<int>>& board, int row, int col, int num) {
-    for (int x = 0; x < N; x++) {
-        if (board[row][x] == num || board[x][col] == num ||
-            board[row - row % 3 + x / 3][col - col % 3 + x % 3] == num) {
-            return false;
-        }
-    }
+bool solveSudoku(vector<vector<int>>& board) {
+    SudokuSolver solver;
+    if (!solver.load(board) || !solver.solve())
+        return false;
+    solver.store(board);
     return true;
 }
 
-bool solveSudoku(vector<vector<int>>& board, int row, int col, vector<vector<bool>>& fixedCells) {
-    if (row == N - 1 && col == N)
-        return true;
-    if (col == N) {
-        row++;
-        col = 0;
-    }
-    if (fixedCells[row][col])
-        return solveSudoku(board, row, col + 1, fixedCells);
-
-    for (int num = 1; num <= N; num++) {
-        if (isSafe(board, row, col, num)) {
-            board[row][col] = num;
-            if (solveSudoku(board, row, col + 1, fixedCells))
-                return true;
-            board[row][col] = 0;
-        }
-    }
-    return false;
-}
-
 void drawGrid(RenderWindow& window, const vector<vector<int>>& board, const vector<vector<bool>>& fixedCells, Font& font) {
     RectangleShape line(Vector2f(540, 1));
     line.setFillColor(Color::Black);
@@ -97,7 +75,7 @@ int main() {
         return -1;
     }
 
-    if (!solveSudoku(board, 0, 0, fixedCells)) {
+    if (!solveSudoku(board)) {
         cerr << "No solution exists" << endl;
         return -1;
     }
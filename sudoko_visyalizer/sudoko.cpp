@@ -1,9 +1,14 @@
 #include <SFML/Graphics.hpp>
 #include <vector>
+#include <string>
 #include <iostream>
 #include <thread>
-#include <chrono>
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
 #include <fstream> // For file existence check
+#include "SudokuSolver.h"
+#include "StepRing.h"
 
 using namespace std;
 using namespace sf;
@@ -11,12 +16,27 @@ using namespace sf;
 #define N 9
 #define UNASSIGNED 0
 
+const unsigned DIGIT_SIZE = 24;
+
+// One solver move: `digit` placed in `cell`, or taken back out of it if
+// `undo` is set. Keeping the digit for undos too lets playback run
+// backwards.
+struct Step {
+    uint8_t cell;
+    uint8_t digit;
+    uint8_t undo;
+};
+
+typedef StepRing<Step, 1 << 14> StepQueue;
+
+enum SolverState { SOLVER_RUNNING, SOLVER_SOLVED, SOLVER_FAILED };
+
 bool fileExists(const string& filename) {
     ifstream file(filename);
     return file.good();
 }
 
-void drawGrid(RenderWindow& window, const vector<vector<int>>& board, Font& font) {
+void drawGrid(RenderWindow& window) {
     RectangleShape line(Vector2f(540, 1));
     line.setFillColor(Color::Black);
 
@@ -28,65 +48,150 @@ void drawGrid(RenderWindow& window, const vector<vector<int>>& board, Font& font
         window.draw(line);
         line.setRotation(0);
     }
+}
 
-    for (int i = 0; i < N; i++) {
-        for (int j = 0; j < N; j++) {
-            if (board[i][j] != UNASSIGNED) {
-                Text number(to_string(board[i][j]), font, 24);
-                number.setFillColor(Color::Black);
-                number.setPosition(j * 60 + 20, i * 60 + 10);
-                window.draw(number);
-            }
-        }
+// The board's digits as one vertex array of textured quads, four vertices
+// per cell, cut from the font's glyph texture. Glyphs are looked up once,
+// a move rewrites only its cell's quad and a frame is a single draw call.
+class DigitLayer {
+public:
+    void load(const Font& font) {
+        for (int digit = 1; digit <= N; digit++) glyphs[digit] = font.getGlyph('0' + digit, DIGIT_SIZE, false);
+        // Taken after the lookups, which may have grown the texture
+        texture = &font.getTexture(DIGIT_SIZE);
+        quads.setPrimitiveType(Quads);
+        quads.resize(4 * N * N);
     }
-}
 
-bool isSafe(vector<vector<int>>& board, int row, int col, int num) {
-    for (int x = 0; x < N; x++) {
-        if (board[row][x] == num || board[x][col] == num || 
-            board[row - row % 3 + x / 3][col - col % 3 + x % 3] == num) {
-            return false;
+    void set(int cell, int digit) {
+        Vertex* quad = &quads[4 * cell];
+        if (digit == UNASSIGNED) {
+            for (int k = 0; k < 4; k++) quad[k].position = Vector2f(0, 0);
+            return;
         }
+
+        // Where sf::Text put the digit: pen at (20, 10) in the cell, glyph
+        // bounds relative to the baseline one character size lower
+        const Glyph& glyph = glyphs[digit];
+        float x = cell % N * 60 + 20 + glyph.bounds.left;
+        float y = cell / N * 60 + 10 + DIGIT_SIZE + glyph.bounds.top;
+        float w = glyph.bounds.width, h = glyph.bounds.height;
+        float u = glyph.textureRect.left, v = glyph.textureRect.top;
+        float tw = glyph.textureRect.width, th = glyph.textureRect.height;
+
+        quad[0] = Vertex(Vector2f(x, y), Color::Black, Vector2f(u, v));
+        quad[1] = Vertex(Vector2f(x + w, y), Color::Black, Vector2f(u + tw, v));
+        quad[2] = Vertex(Vector2f(x + w, y + h), Color::Black, Vector2f(u + tw, v + th));
+        quad[3] = Vertex(Vector2f(x, y + h), Color::Black, Vector2f(u, v + th));
     }
-    return true;
-}
 
-bool solveSudoku(RenderWindow& window, vector<vector<int>>& board, int row, int col, Font& font) {
-    if (row == N - 1 && col == N)
-        return true;
-    if (col == N) {
-        row++;
-        col = 0;
-    }
-    if (board[row][col] != UNASSIGNED)
-        return solveSudoku(window, board, row, col + 1, font);
-    
-    for (int num = 1; num <= N; num++) {
-        if (isSafe(board, row, col, num)) {
-            board[row][col] = num;
-
-            // Update window and sleep for visualization
-            window.clear(Color::White);
-            drawGrid(window, board, font);
-            window.display();
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-
-            if (solveSudoku(window, board, row, col + 1, font))
-                return true;
-            board[row][col] = UNASSIGNED;
-
-            // Update window and sleep for visualization
-            window.clear(Color::White);
-            drawGrid(window, board, font);
-            window.display();
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        }
+    void draw(RenderWindow& window) const {
+        window.draw(quads, RenderStates(texture));
+    }
+
+private:
+    Glyph glyphs[N + 1];
+    const Texture* texture = nullptr;
+    VertexArray quads;
+};
+
+// Function to solve the board at full speed on the solver thread, sending
+// every move to `steps`. It never touches the window; if the ring is full it
+// waits for the render thread to drain it, and once `stop` is set it drops
+// the remaining moves so the search can finish quickly.
+void recordSolve(vector<vector<int>> board, StepQueue& steps, atomic<int>& state, const atomic<bool>& stop) {
+    SudokuSolver solver;
+    if (!solver.load(board)) {
+        state.store(SOLVER_FAILED, memory_order_release);
+        return;
     }
-    return false;
+
+    solver.setObserver([&](int cell, int value) {
+        int& current = board[cell / N][cell % N];
+        Step step = { static_cast<uint8_t>(cell), static_cast<uint8_t>(value != UNASSIGNED ? value : current),
+                      static_cast<uint8_t>(value == UNASSIGNED) };
+        current = value;
+        while (!stop.load(memory_order_relaxed) && !steps.push(step)) this_thread::yield();
+    });
+    bool solved = solver.solve();
+    state.store(solved ? SOLVER_SOLVED : SOLVER_FAILED, memory_order_release);
 }
 
+// Render-side copy of every recorded move and the board as of the playhead.
+// The playhead advances at `speed` moves per second of wall time, whatever
+// the frame rate, and can be paused, stepped and moved anywhere in the
+// recording.
+class Playback {
+public:
+    Playback(const vector<vector<int>>& givens, DigitLayer& digits) : board(givens), digits(digits) {
+        for (int cell = 0; cell < N * N; cell++) digits.set(cell, board[cell / N][cell % N]);
+    }
+
+    // Function to append the moves the solver has sent since the last call
+    void drain(StepQueue& steps) {
+        Step batch[1024];
+        size_t n;
+        while ((n = steps.pop(batch, 1024)) > 0) history.insert(history.end(), batch, batch + n);
+    }
+
+    void advance(float seconds) {
+        if (paused) return;
+        playhead = min(playhead + speed * seconds, static_cast<double>(history.size()));
+        moveTo(static_cast<size_t>(playhead));
+    }
+
+    // Function to jump by `delta` moves and pause there
+    void skip(long long delta) {
+        long long target = static_cast<long long>(position) + delta;
+        target = max(0LL, min(target, static_cast<long long>(history.size())));
+        paused = true;
+        seek(static_cast<size_t>(target));
+    }
+
+    void seek(size_t target) {
+        moveTo(min(target, history.size()));
+        playhead = static_cast<double>(position);
+    }
+
+    void togglePause() { paused = !paused; }
+    void faster() { speed = min(speed * 2, 1e7); }
+    void slower() { speed = max(speed / 2, 0.5); }
+
+    size_t recorded() const { return history.size(); }
+
+    string status(int state) const {
+        string text = "Sudoku Solver - step " + to_string(position) + " / " + to_string(history.size());
+        text += ", " + to_string(static_cast<long long>(speed)) + " steps/s";
+        if (paused) text += ", paused";
+        if (state == SOLVER_RUNNING) text += ", solving";
+        if (state == SOLVER_FAILED) text += ", no solution";
+        return text;
+    }
+
+private:
+    void moveTo(size_t target) {
+        for (; position < target; position++) apply(history[position], false);
+        for (; position > target; position--) apply(history[position - 1], true);
+    }
+
+    void apply(const Step& step, bool backwards) {
+        int value = step.undo != backwards ? UNASSIGNED : step.digit;
+        board[step.cell / N][step.cell % N] = value;
+        digits.set(step.cell, value);
+    }
+
+    vector<vector<int>> board;
+    DigitLayer& digits;
+    vector<Step> history;
+    size_t position = 0;  // moves applied to `board`
+    double playhead = 0;  // fractional position the speed advances
+    double speed = 10;    // moves per second
+    bool paused = false;
+};
+
 int main() {
     RenderWindow window(VideoMode(540, 540), "Sudoku Solver");
+    window.setFramerateLimit(60);
 
     vector<vector<int>> board = {
         {5, 3, 0, 0, 7, 0, 0, 0, 0},
@@ -111,22 +216,64 @@ int main() {
         return -1;
     }
 
-    std::thread solverThread([&]() {
-        solveSudoku(window, board, 0, 0, font);
-    });
+    DigitLayer digits;
+    digits.load(font);
+    Playback playback(board, digits);
+
+    // Static: the ring is too big for the main thread's stack on some systems
+    static StepQueue steps;
+    atomic<int> state(SOLVER_RUNNING);
+    atomic<bool> stop(false);
+    std::thread solverThread(recordSolve, board, ref(steps), ref(state), cref(stop));
 
+    // Space pauses, Up/Down double or halve the speed, Left/Right step one
+    // move (1000 with Shift), Home and End jump to the start and to the
+    // latest recorded move
+    Clock clock;
+    bool reported = false;
+    string title;
     while (window.isOpen()) {
         Event event;
         while (window.pollEvent(event)) {
-            if (event.type == Event::Closed)
+            if (event.type == Event::Closed) {
                 window.close();
+            } else if (event.type == Event::KeyPressed) {
+                long long stride = event.key.shift ? 1000 : 1;
+                switch (event.key.code) {
+                case Keyboard::Space: playback.togglePause(); break;
+                case Keyboard::Up: playback.faster(); break;
+                case Keyboard::Down: playback.slower(); break;
+                case Keyboard::Right: playback.skip(stride); break;
+                case Keyboard::Left: playback.skip(-stride); break;
+                case Keyboard::Home: playback.seek(0); break;
+                case Keyboard::End: playback.seek(playback.recorded()); break;
+                default: break;
+                }
+            }
+        }
+
+        // Read the state first: once it is final every move is in the ring
+        int solverState = state.load(memory_order_acquire);
+        playback.drain(steps);
+        playback.advance(clock.restart().asSeconds());
+        if (solverState == SOLVER_FAILED && !reported) {
+            cerr << "No solution exists" << endl;
+            reported = true;
+        }
+
+        string status = playback.status(solverState);
+        if (status != title) {
+            window.setTitle(status);
+            title = status;
         }
 
         window.clear(Color::White);
-        drawGrid(window, board, font);
+        drawGrid(window);
+        digits.draw(window);
         window.display();
     }
 
+    stop.store(true, memory_order_relaxed);
     solverThread.join();
     return 0;
 }